@@ -108,4 +108,20 @@
 #define ST7789_NVMSET     0xFC
 #define ST7789_PROMACT    0xFE
 
+// Memory Data Access Control Bits
+#define ST7789_MADCTL_MY  0x80
+#define ST7789_MADCTL_MX  0x40
+#define ST7789_MADCTL_MV  0x20
+#define ST7789_MADCTL_ML  0x10
+#define ST7789_MADCTL_BGR 0x08
+#define ST7789_MADCTL_MH  0x04
+
+// Driver Specific Controls
+//  SCROLL_AREA:  ptr = ST7789_SCROLL_AREA(first line, lines), 0 lines turns scrolling off
+//  SCROLL_START: ptr = scroll offset in lines, the scroll area is along the long side
+#define GDISP_CONTROL_ST7789_SCROLL_AREA  (GDISP_CONTROL_LLD + 0)
+#define GDISP_CONTROL_ST7789_SCROLL_START (GDISP_CONTROL_LLD + 1)
+
+#define ST7789_SCROLL_AREA(a, n) ((void *)(((uint32_t)(a) << 16) | ((uint32_t)(n) & 0xFFFF)))
+
 #endif  // _ST7789_H
@@ -5,6 +5,8 @@
  *      Author: Jack Chen <redchenjs@live.com>
  */
 
+#include <string.h>
+
 #include "gfx.h"
 
 #if GFX_USE_GDISP
@@ -43,102 +45,167 @@
 #endif
 
 #define GDISP_FLG_NEEDFLUSH         (GDISP_FLG_DRIVER << 0)
+#define GDISP_FLG_NEEDSCROLL        (GDISP_FLG_DRIVER << 1)
+
+#define GDISP_GRAM_HEIGHT           320
+#define GDISP_GRAM_OFFSET           ((GDISP_GRAM_HEIGHT - GDISP_SCREEN_HEIGHT) / 2)
+
+#ifdef CONFIG_LCD_RENDER_MODE_STRIP
+    #define GDISP_STRIP_SIZE        ST7789_STRIP_SIZE
+    #define GDISP_PRIV_SIZE         (GDISP_STRIP_SIZE * 2 * 2)
+#else
+    #define GDISP_PRIV_SIZE         (GDISP_SCREEN_WIDTH * GDISP_SCREEN_HEIGHT * 2)
+#endif
 
 #include "ST7789.h"
 
+#ifdef CONFIG_LCD_RENDER_MODE_STRIP
+    static uint8_t view_x = 52;
+    static uint8_t view_y = 40;
+
+    static void set_viewport(GDisplay *g) {
+        uint16_t x0 = view_x + g->p.x;
+        uint16_t x1 = view_x + g->p.x + g->p.cx - 1;
+        uint16_t y0 = view_y + g->p.y;
+        uint16_t y1 = view_y + g->p.y + g->p.cy - 1;
+
+        uint8_t caset[4] = {x0 >> 8, x0 & 0xFF, x1 >> 8, x1 & 0xFF};
+        uint8_t raset[4] = {y0 >> 8, y0 & 0xFF, y1 >> 8, y1 & 0xFF};
+
+        write_cmd_data(g, ST7789_CASET, caset, 4);
+        write_cmd_data(g, ST7789_RASET, raset, 4);
+        write_cmd_data(g, ST7789_RAMWR, NULL, 0);
+    }
+#endif
+
+#if GDISP_NEED_CONTROL && GDISP_HARDWARE_CONTROL
+    static uint16_t scroll_tfa = 0;
+    static uint16_t scroll_vsa = 0;
+    static uint16_t scroll_ssa = 0;
+
+    static void set_scroll_area(GDisplay *g, uint16_t a, uint16_t n) {
+        if (n == 0 || a + n > GDISP_SCREEN_HEIGHT) {
+            scroll_tfa = 0;
+            scroll_vsa = 0;
+        } else {
+            // GRAM rows run along the long side, backwards for 90 and 180 degrees
+            switch (g->g.Orientation) {
+                case GDISP_ROTATE_0:
+                case GDISP_ROTATE_270:
+                default:
+                    scroll_tfa = GDISP_GRAM_OFFSET + a;
+                    break;
+                case GDISP_ROTATE_90:
+                case GDISP_ROTATE_180:
+                    scroll_tfa = GDISP_GRAM_OFFSET + GDISP_SCREEN_HEIGHT - a - n;
+                    break;
+            }
+            scroll_vsa = n;
+        }
+        scroll_ssa = scroll_tfa;
+
+        uint16_t vsa = scroll_vsa ? scroll_vsa : GDISP_GRAM_HEIGHT;
+        uint16_t bfa = GDISP_GRAM_HEIGHT - scroll_tfa - vsa;
+        uint8_t vscrdef[6] = {scroll_tfa >> 8, scroll_tfa & 0xFF, vsa >> 8, vsa & 0xFF, bfa >> 8, bfa & 0xFF};
+        uint8_t vscrsadd[2] = {scroll_ssa >> 8, scroll_ssa & 0xFF};
+
+        write_cmd_data(g, ST7789_VSCRDEF, vscrdef, 6);
+        write_cmd_data(g, ST7789_VSCRSADD, vscrsadd, 2);
+
+        g->flags &= ~GDISP_FLG_NEEDSCROLL;
+    }
+
+    static void set_scroll_start(GDisplay *g, uint16_t s) {
+        if (scroll_vsa == 0) {
+            return;
+        }
+        s %= scroll_vsa;
+        switch (g->g.Orientation) {
+            case GDISP_ROTATE_0:
+            case GDISP_ROTATE_270:
+            default:
+                scroll_ssa = scroll_tfa + s;
+                break;
+            case GDISP_ROTATE_90:
+            case GDISP_ROTATE_180:
+                scroll_ssa = scroll_tfa + (scroll_vsa - s) % scroll_vsa;
+                break;
+        }
+    #ifdef CONFIG_LCD_RENDER_MODE_STRIP
+        uint8_t vscrsadd[2] = {scroll_ssa >> 8, scroll_ssa & 0xFF};
+
+        write_cmd_data(g, ST7789_VSCRSADD, vscrsadd, 2);
+    #else
+        // applied by the next flush so the new lines and the offset show up together
+        g->flags |= GDISP_FLG_NEEDFLUSH | GDISP_FLG_NEEDSCROLL;
+    #endif
+    }
+#endif
+
+typedef struct {
+    uint8_t cmd;
+    uint8_t len;
+    uint8_t delay;
+    uint8_t data[14];
+} init_cmd_t;
+
+DRAM_ATTR static const init_cmd_t init_cmds[] = {
+    { ST7789_SWRESET,    0, 120, { 0 } },                  //  1: software reset, no args, w/delay
+    { ST7789_SLPOUT,     0,  10, { 0 } },                  //  2: out of sleep mode, no args, w/delay
+    { ST7789_PORCTRL,    5,   0, { 0x0C, 0x0C, 0x00,       //  3: porch setting, 5 args, no delay:
+                                   0x33, 0x33 } },
+    { ST7789_GCTRL,      1,   0, { 0x35 } },               //  4: gate control, 1 arg, no delay:
+    { ST7789_VCOMS,      1,   0, { 0x19 } },               //  5: VCOM setting, 1 arg, no delay:
+    { ST7789_LCMCTRL,    1,   0, { 0x2C } },               //  6: LCM control, 1 arg, no delay:
+    { ST7789_VDVVRHEN,   1,   0, { 0x01 } },               //  7: VDV and VRH command enable, 1 arg, no delay:
+    { ST7789_VRHS,       1,   0, { 0x12 } },               //  8: VRH setting, 1 arg, no delay:
+    { ST7789_VDVSET,     1,   0, { 0x20 } },               //  9: VDV setting, 1 arg, no delay:
+    { ST7789_FRCTRL2,    1,   0, { 0x01 } },               // 10: frame rate control - normal mode, 1 arg:
+    { ST7789_PWCTRL1,    2,   0, { 0xA4, 0xA1 } },         // 11: power control 1, 2 args, no delay:
+    { ST7789_INVON,      0,   0, { 0 } },                  // 12: invert display, no args, no delay
+    { ST7789_MADCTL,     1,   0, { 0x00 } },               // 13: memory access control (directions), 1 arg:
+    { ST7789_COLMOD,     1,   0, { 0x05 } },               // 14: set color mode, 1 arg, no delay:
+    { ST7789_PVGAMCTRL, 14,   0, { 0xD0, 0x04, 0x0D,       // 15: positive voltage gamma control, 14 args, no delay:
+                                   0x11, 0x13, 0x2B,
+                                   0x3F, 0x54, 0x4C,
+                                   0x18, 0x0D, 0x0B,
+                                   0x1F, 0x23 } },
+    { ST7789_NVGAMCTRL, 14,   0, { 0xD0, 0x04, 0x0C,       // 16: negative voltage gamma control, 14 args, no delay:
+                                   0x11, 0x13, 0x2C,
+                                   0x3F, 0x44, 0x51,
+                                   0x2F, 0x1F, 0x1F,
+                                   0x20, 0x23 } },
+    { ST7789_NORON,      0,   0, { 0 } },                  // 17: normal display on, no args, no delay
+    { ST7789_CASET,      4,   0, { 0x00, 0x34,             // 18: set column address, 4 args, no delay:
+                                   0x00, 0xBA } },
+    { ST7789_RASET,      4,   0, { 0x00, 0x28,             // 19: set row address, 4 args, no delay:
+                                   0x01, 0x17 } },
+    { ST7789_DISPON,     0,   0, { 0 } }                   // 20: main screen turn on, no args, no delay
+};
+
 LLDSPEC bool_t gdisp_lld_init(GDisplay *g) {
-    g->priv = gfxAlloc(GDISP_SCREEN_WIDTH * GDISP_SCREEN_HEIGHT * 2);
+    g->priv = gfxAllocCaps(GDISP_PRIV_SIZE, GFX_ALLOC_DMA);
     if (g->priv == NULL) {
         gfxHalt("GDISP ST7789: Failed to allocate private memory");
     }
 
-    memset(g->priv, 0x00, GDISP_SCREEN_WIDTH * GDISP_SCREEN_HEIGHT * 2);
+    memset(g->priv, 0x00, GDISP_PRIV_SIZE);
 
     // initialise the board interface
     init_board(g);
 
     // hardware reset
     setpin_reset(g, 0);
-    gfxSleepMilliseconds(120);
+    gfxSleepMilliseconds(10);
     setpin_reset(g, 1);
     gfxSleepMilliseconds(120);
 
-    write_cmd(g, ST7789_SWRESET);   //  1: software reset, no args, w/delay
-    gfxSleepMilliseconds(120);
-    write_cmd(g, ST7789_SLPOUT);    //  2: out of sleep mode, no args, w/delay
-    gfxSleepMilliseconds(120);
-    write_cmd(g, ST7789_PORCTRL);   //  3: porch setting, 5 args, no delay:
-        write_data(g, 0x0C);
-        write_data(g, 0x0C);
-        write_data(g, 0x00);
-        write_data(g, 0x33);
-        write_data(g, 0x33);
-    write_cmd(g, ST7789_GCTRL);     //  4: gate control, 1 arg, no delay:
-        write_data(g, 0x35);
-    write_cmd(g, ST7789_VCOMS);     //  5: VCOM setting, 1 arg, no delay:
-        write_data(g, 0x19);
-    write_cmd(g, ST7789_LCMCTRL);   //  6: LCM control, 1 arg, no delay:
-        write_data(g, 0x2C);
-    write_cmd(g, ST7789_VDVVRHEN);  //  7: VDV and VRH command enable, 1 arg, no delay:
-        write_data(g, 0x01);
-    write_cmd(g, ST7789_VRHS);      //  8: VRH setting, 1 arg, no delay:
-        write_data(g, 0x12);
-    write_cmd(g, ST7789_VDVSET);    //  9: VDV setting, 1 arg, no delay:
-        write_data(g, 0x20);
-    write_cmd(g, ST7789_FRCTRL2);   // 10: frame rate control - normal mode, 1 arg:
-        write_data(g, 0x01);
-    write_cmd(g, ST7789_PWCTRL1);   // 11: power control 1, 2 args, no delay:
-        write_data(g, 0xA4);
-        write_data(g, 0xA1);
-    write_cmd(g, ST7789_INVON);     // 12: invert display, no args, no delay
-    write_cmd(g, ST7789_MADCTL);    // 13: memory access control (directions), 1 arg:
-        write_data(g, 0x00);
-    write_cmd(g, ST7789_COLMOD);    // 14: set color mode, 1 arg, no delay:
-        write_data(g, 0x05);
-    write_cmd(g, ST7789_PVGAMCTRL); // 15: positive voltage gamma control, 14 args, no delay:
-        write_data(g, 0xD0);
-        write_data(g, 0x04);
-        write_data(g, 0x0D);
-        write_data(g, 0x11);
-        write_data(g, 0x13);
-        write_data(g, 0x2B);
-        write_data(g, 0x3F);
-        write_data(g, 0x54);
-        write_data(g, 0x4C);
-        write_data(g, 0x18);
-        write_data(g, 0x0D);
-        write_data(g, 0x0B);
-        write_data(g, 0x1F);
-        write_data(g, 0x23);
-    write_cmd(g, ST7789_NVGAMCTRL); // 16: negative voltage gamma control, 14 args, no delay:
-        write_data(g, 0xD0);
-        write_data(g, 0x04);
-        write_data(g, 0x0C);
-        write_data(g, 0x11);
-        write_data(g, 0x13);
-        write_data(g, 0x2C);
-        write_data(g, 0x3F);
-        write_data(g, 0x44);
-        write_data(g, 0x51);
-        write_data(g, 0x2F);
-        write_data(g, 0x1F);
-        write_data(g, 0x1F);
-        write_data(g, 0x20);
-        write_data(g, 0x23);
-    write_cmd(g, ST7789_NORON);     // 17: normal display on, no args, no delay
-    write_cmd(g, ST7789_CASET);     // 18: set column address, 4 args, no delay:
-        write_data(g, 0x00);
-        write_data(g, 0x34);
-        write_data(g, 0x00);
-        write_data(g, 0xBA);
-    write_cmd(g, ST7789_RASET);     // 19: set row address, 4 args, no delay:
-        write_data(g, 0x00);
-        write_data(g, 0x28);
-        write_data(g, 0x01);
-        write_data(g, 0x17);
-    write_cmd(g, ST7789_RAMWR);     // 20: set write ram, N args, no delay:
-        write_buff(g, (uint8_t *)g->priv, GDISP_SCREEN_WIDTH * GDISP_SCREEN_HEIGHT * 2);
-    write_cmd(g, ST7789_DISPON);    // 21: main screen turn on, no args, no delay
+    for (const init_cmd_t *p = init_cmds; p < init_cmds + sizeof(init_cmds) / sizeof(init_cmds[0]); p++) {
+        write_cmd_data(g, p->cmd, p->data, p->len);
+        if (p->delay) {
+            gfxSleepMilliseconds(p->delay);
+        }
+    }
 
     /* initialise the GDISP structure */
     g->g.Width  = GDISP_SCREEN_WIDTH;
@@ -157,20 +224,57 @@ LLDSPEC bool_t gdisp_lld_init(GDisplay *g) {
             return;
         }
         refresh_gram(g, (uint8_t *)g->priv);
-        g->flags &= ~GDISP_FLG_NEEDFLUSH;
+    #if GDISP_NEED_CONTROL && GDISP_HARDWARE_CONTROL
+        if (g->flags & GDISP_FLG_NEEDSCROLL) {
+            uint8_t vscrsadd[2] = {scroll_ssa >> 8, scroll_ssa & 0xFF};
+            write_cmd_data(g, ST7789_VSCRSADD, vscrsadd, 2);
+        }
+    #endif
+        g->flags &= ~(GDISP_FLG_NEEDFLUSH | GDISP_FLG_NEEDSCROLL);
     }
 #endif
 
-#if GDISP_HARDWARE_STREAM_WRITE
+#if GDISP_HARDWARE_STREAM_WRITE && defined(CONFIG_LCD_RENDER_MODE_STRIP)
+    static uint8_t  strip_idx = 0;
+    static uint32_t strip_pos = 0;
+    static void write_strip_buff(GDisplay *g) {
+        write_strip(g, (uint8_t *)g->priv + strip_idx * GDISP_STRIP_SIZE * 2, strip_pos * 2);
+        strip_idx = !strip_idx;
+        strip_pos = 0;
+    }
+    LLDSPEC void gdisp_lld_write_start(GDisplay *g) {
+        set_viewport(g);
+        strip_pos = 0;
+    }
+    LLDSPEC void gdisp_lld_write_color(GDisplay *g) {
+        uint8_t *buff = (uint8_t *)g->priv + strip_idx * GDISP_STRIP_SIZE * 2;
+        LLDCOLOR_TYPE c = gdispColor2Native(g->p.color);
+        buff[strip_pos * 2 + 0] = c >> 8;
+        buff[strip_pos * 2 + 1] = c;
+        if (++strip_pos == GDISP_STRIP_SIZE) {
+            write_strip_buff(g);
+        }
+    }
+    LLDSPEC void gdisp_lld_write_stop(GDisplay *g) {
+        if (strip_pos != 0) {
+            write_strip_buff(g);
+        }
+    }
+#elif GDISP_HARDWARE_STREAM_WRITE
+    // the window is kept here, callers may move g->p.x and g->p.y while streaming
+    static uint8_t write_x0 = 0;
+    static uint8_t write_w  = 0;
+    static uint8_t write_y0 = 0;
+    static uint8_t write_h  = 0;
     static uint8_t write_x  = 0;
     static uint8_t write_cx = 0;
     static uint8_t write_y  = 0;
     static uint8_t write_cy = 0;
     LLDSPEC void gdisp_lld_write_start(GDisplay *g) {
-        write_x  = g->p.x;
-        write_cx = g->p.cx;
-        write_y  = g->p.y;
-        write_cy = g->p.cy;
+        write_x0 = write_x  = g->p.x;
+        write_w  = write_cx = g->p.cx;
+        write_y0 = write_y  = g->p.y;
+        write_h  = write_cy = g->p.cy;
     }
     LLDSPEC void gdisp_lld_write_color(GDisplay *g) {
         uint16_t pos = 0;
@@ -194,12 +298,12 @@ LLDSPEC bool_t gdisp_lld_init(GDisplay *g) {
         *((uint8_t *)g->priv + pos * 2 + 1) = c;
         write_x++;
         if (--write_cx == 0) {
-            write_x  = g->p.x;
-            write_cx = g->p.cx;
+            write_x  = write_x0;
+            write_cx = write_w;
             write_y++;
             if (--write_cy == 0) {
-                write_y  = g->p.y;
-                write_cy = g->p.cy;
+                write_y  = write_y0;
+                write_cy = write_h;
             }
         }
     }
@@ -208,16 +312,90 @@ LLDSPEC bool_t gdisp_lld_init(GDisplay *g) {
     }
 #endif
 
+#if GDISP_HARDWARE_FILLS || GDISP_HARDWARE_BITFILLS || GDISP_HARDWARE_PIXELREAD
+    // framebuffer index of (x, y) and the index steps for the next pixel and the next row
+    static int32_t get_fb_pos(GDisplay *g, coord_t x, coord_t y, int32_t *dx, int32_t *dy) {
+        switch (g->g.Orientation) {
+            case GDISP_ROTATE_0:
+            default:
+                *dx = 1;
+                *dy = g->g.Width;
+                return y * g->g.Width + x;
+            case GDISP_ROTATE_90:
+                *dx = -g->g.Height;
+                *dy = 1;
+                return (g->g.Width - x - 1) * g->g.Height + y;
+            case GDISP_ROTATE_180:
+                *dx = -1;
+                *dy = -g->g.Width;
+                return (g->g.Height - y - 1) * g->g.Width + (g->g.Width - x - 1);
+            case GDISP_ROTATE_270:
+                *dx = g->g.Height;
+                *dy = -1;
+                return x * g->g.Height + (g->g.Height - y - 1);
+        }
+    }
+#endif
+
+#if GDISP_HARDWARE_FILLS
+    LLDSPEC void gdisp_lld_fill_area(GDisplay *g) {
+        int32_t dx = 0, dy = 0;
+        int32_t pos = get_fb_pos(g, g->p.x, g->p.y, &dx, &dy);
+        LLDCOLOR_TYPE c = gdispColor2Native(g->p.color);
+        uint16_t v = (c >> 8) | (c << 8);
+        uint16_t *fb = (uint16_t *)g->priv;
+        for (coord_t y = 0; y < g->p.cy; y++, pos += dy) {
+            uint16_t *p = fb + pos;
+            for (coord_t x = 0; x < g->p.cx; x++, p += dx) {
+                *p = v;
+            }
+        }
+        g->flags |= GDISP_FLG_NEEDFLUSH;
+    }
+#endif
+
+#if GDISP_HARDWARE_BITFILLS
+    LLDSPEC void gdisp_lld_blit_area(GDisplay *g) {
+        int32_t dx = 0, dy = 0;
+        int32_t pos = get_fb_pos(g, g->p.x, g->p.y, &dx, &dy);
+        const pixel_t *src = (const pixel_t *)g->p.ptr + g->p.y1 * g->p.x2 + g->p.x1;
+        uint16_t *fb = (uint16_t *)g->priv;
+        for (coord_t y = 0; y < g->p.cy; y++, pos += dy, src += g->p.x2) {
+            uint16_t *p = fb + pos;
+            // source rows are in CPU order, the framebuffer holds the panel's big-endian pixels
+            for (coord_t x = 0; x < g->p.cx; x++, p += dx) {
+                LLDCOLOR_TYPE c = gdispColor2Native(src[x]);
+                *p = (c >> 8) | (c << 8);
+            }
+        }
+        g->flags |= GDISP_FLG_NEEDFLUSH;
+    }
+#endif
+
+#if GDISP_HARDWARE_PIXELREAD
+    LLDSPEC color_t gdisp_lld_get_pixel_color(GDisplay *g) {
+        int32_t dx = 0, dy = 0;
+        uint16_t v = *((uint16_t *)g->priv + get_fb_pos(g, g->p.x, g->p.y, &dx, &dy));
+        LLDCOLOR_TYPE c = (v >> 8) | (v << 8);
+        return gdispNative2Color(c);
+    }
+#endif
+
 #if GDISP_HARDWARE_STREAM_READ
+    // the window is kept here, callers may move g->p.x and g->p.y while streaming
+    static uint8_t read_x0 = 0;
+    static uint8_t read_w  = 0;
+    static uint8_t read_y0 = 0;
+    static uint8_t read_h  = 0;
     static uint8_t read_x  = 0;
     static uint8_t read_cx = 0;
     static uint8_t read_y  = 0;
     static uint8_t read_cy = 0;
     LLDSPEC void gdisp_lld_read_start(GDisplay *g) {
-        read_x  = g->p.x;
-        read_cx = g->p.cx;
-        read_y  = g->p.y;
-        read_cy = g->p.cy;
+        read_x0 = read_x  = g->p.x;
+        read_w  = read_cx = g->p.cx;
+        read_y0 = read_y  = g->p.y;
+        read_h  = read_cy = g->p.cy;
     }
     LLDSPEC color_t gdisp_lld_read_color(GDisplay *g) {
         uint16_t pos = 0;
@@ -240,12 +418,12 @@ LLDSPEC bool_t gdisp_lld_init(GDisplay *g) {
                         | (*((uint8_t *)g->priv + pos * 2 + 1));
         read_x++;
         if (--read_cx == 0) {
-            read_x  = g->p.x;
-            read_cx = g->p.cx;
+            read_x  = read_x0;
+            read_cx = read_w;
             read_y++;
             if (--read_cy == 0) {
-                read_y  = g->p.y;
-                read_cy = g->p.cy;
+                read_y  = read_y0;
+                read_cy = read_h;
             }
         }
         return c;
@@ -260,27 +438,55 @@ LLDSPEC void gdisp_lld_control(GDisplay *g) {
         if (g->g.Orientation == (orientation_t)g->p.ptr) {
             return;
         }
+    #ifdef CONFIG_LCD_RENDER_MODE_STRIP
+        uint8_t madctl = 0x00;
+    #endif
         switch ((orientation_t)g->p.ptr) {
             case GDISP_ROTATE_0:
                 g->g.Width  = GDISP_SCREEN_WIDTH;
                 g->g.Height = GDISP_SCREEN_HEIGHT;
+            #ifdef CONFIG_LCD_RENDER_MODE_STRIP
+                madctl = 0x00;
+                view_x = 52;
+                view_y = 40;
+            #endif
                 break;
             case GDISP_ROTATE_90:
                 g->g.Width  = GDISP_SCREEN_HEIGHT;
                 g->g.Height = GDISP_SCREEN_WIDTH;
+            #ifdef CONFIG_LCD_RENDER_MODE_STRIP
+                madctl = ST7789_MADCTL_MY | ST7789_MADCTL_MV;
+                view_x = 40;
+                view_y = 52;
+            #endif
                 break;
             case GDISP_ROTATE_180:
                 g->g.Width  = GDISP_SCREEN_WIDTH;
                 g->g.Height = GDISP_SCREEN_HEIGHT;
+            #ifdef CONFIG_LCD_RENDER_MODE_STRIP
+                madctl = ST7789_MADCTL_MY | ST7789_MADCTL_MX;
+                view_x = 53;
+                view_y = 40;
+            #endif
                 break;
             case GDISP_ROTATE_270:
                 g->g.Width  = GDISP_SCREEN_HEIGHT;
                 g->g.Height = GDISP_SCREEN_WIDTH;
+            #ifdef CONFIG_LCD_RENDER_MODE_STRIP
+                madctl = ST7789_MADCTL_MX | ST7789_MADCTL_MV;
+                view_x = 40;
+                view_y = 53;
+            #endif
                 break;
             default:
                 return;
         }
+    #ifdef CONFIG_LCD_RENDER_MODE_STRIP
+        write_cmd(g, ST7789_MADCTL);
+            write_data(g, madctl);
+    #endif
         g->g.Orientation = (orientation_t)g->p.ptr;
+        set_scroll_area(g, 0, 0);
         return;
     case GDISP_CONTROL_BACKLIGHT:
         if (g->g.Backlight == (uint32_t)g->p.ptr) {
@@ -289,6 +495,12 @@ LLDSPEC void gdisp_lld_control(GDisplay *g) {
         set_backlight(g, (uint32_t)g->p.ptr);
         g->g.Backlight = (uint32_t)g->p.ptr;
         return;
+    case GDISP_CONTROL_ST7789_SCROLL_AREA:
+        set_scroll_area(g, (uint32_t)g->p.ptr >> 16, (uint32_t)g->p.ptr & 0xFFFF);
+        return;
+    case GDISP_CONTROL_ST7789_SCROLL_START:
+        set_scroll_start(g, (uint32_t)g->p.ptr);
+        return;
     default:
         return;
     }
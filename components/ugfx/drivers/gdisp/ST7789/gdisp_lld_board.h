@@ -8,14 +8,18 @@
 #ifndef _GDISP_LLD_BOARD_H
 #define _GDISP_LLD_BOARD_H
 
+#include "esp_attr.h"
+
 #include "board/st7789.h"
 
-#define init_board(g)           st7789_init_board()
-#define set_backlight(g, val)   st7789_set_backlight(val)
-#define setpin_reset(g, val)    st7789_setpin_reset(val)
-#define write_cmd(g, cmd)       st7789_write_cmd(cmd)
-#define write_data(g, data)     st7789_write_data(data)
-#define write_buff(g, buff, n)  st7789_write_buff(buff, n)
-#define refresh_gram(g, gram)   st7789_refresh_gram(gram)
+#define init_board(g)                   st7789_init_board()
+#define set_backlight(g, val)           st7789_set_backlight(val)
+#define setpin_reset(g, val)            st7789_setpin_reset(val)
+#define write_cmd(g, cmd)               st7789_write_cmd(cmd)
+#define write_data(g, data)             st7789_write_data(data)
+#define write_cmd_data(g, cmd, data, n) st7789_write_cmd_data(cmd, data, n)
+#define write_buff(g, buff, n)          st7789_write_buff(buff, n)
+#define write_strip(g, buff, n)         st7789_write_strip(buff, n)
+#define refresh_gram(g, gram)           st7789_refresh_gram(gram)
 
 #endif /* _GDISP_LLD_BOARD_H */
@@ -14,10 +14,20 @@
 /* Driver hardware support.                                                  */
 /*===========================================================================*/
 
-#define GDISP_HARDWARE_FLUSH            TRUE
-#define GDISP_HARDWARE_STREAM_WRITE     TRUE
-#define GDISP_HARDWARE_STREAM_READ      TRUE
-#define GDISP_HARDWARE_CONTROL          TRUE
+#ifdef CONFIG_LCD_RENDER_MODE_STRIP
+    #define GDISP_HARDWARE_FLUSH        FALSE
+    #define GDISP_HARDWARE_STREAM_WRITE TRUE
+    #define GDISP_HARDWARE_STREAM_READ  FALSE
+    #define GDISP_HARDWARE_CONTROL      TRUE
+#else
+    #define GDISP_HARDWARE_FLUSH        TRUE
+    #define GDISP_HARDWARE_STREAM_WRITE TRUE
+    #define GDISP_HARDWARE_STREAM_READ  TRUE
+    #define GDISP_HARDWARE_FILLS        TRUE
+    #define GDISP_HARDWARE_BITFILLS     TRUE
+    #define GDISP_HARDWARE_PIXELREAD    TRUE
+    #define GDISP_HARDWARE_CONTROL      TRUE
+#endif
 
 #define GDISP_LLD_PIXELFORMAT           GDISP_PIXELFORMAT_RGB565
 
@@ -22,6 +22,7 @@
 #ifndef _GFXCONF_H
 #define _GFXCONF_H
 
+#include "sdkconfig.h"
 
 ///////////////////////////////////////////////////////////////////////////
 // GOS - One of these must be defined, preferably in your Makefile       //
@@ -80,7 +81,9 @@
 // #define GDISP_NEED_ARCSECTORS                        TRUE
 // #define GDISP_NEED_CONVEX_POLYGON                    TRUE
 // #define GDISP_NEED_SCROLL                            TRUE
-// #define GDISP_NEED_PIXELREAD                         TRUE
+#ifndef CONFIG_LCD_RENDER_MODE_STRIP
+#define GDISP_NEED_PIXELREAD                         TRUE
+#endif
 #define GDISP_NEED_CONTROL                           TRUE
 // #define GDISP_NEED_QUERY                             TRUE
 #define GDISP_NEED_MULTITHREAD                       TRUE
@@ -89,18 +92,22 @@
 //    #define GDISP_NEED_TEXT_WORDWRAP                 TRUE
 //    #define GDISP_NEED_TEXT_BOXPADLR                 1
 //    #define GDISP_NEED_TEXT_BOXPADTB                 1
-//    #define GDISP_NEED_ANTIALIAS                     TRUE
+   #define GDISP_NEED_ANTIALIAS                     TRUE
+#ifdef CONFIG_LCD_RENDER_MODE_STRIP
+   #define GDISP_ANTIALIAS_FILLED_ONLY              TRUE    // Strips cannot be read back, all GUI text is filled
+#endif
 //    #define GDISP_NEED_UTF8                          TRUE
 //    #define GDISP_NEED_TEXT_KERNING                  TRUE
+   #define GDISP_NEED_TEXT_WIDTHCACHE               TRUE
 //    #define GDISP_INCLUDE_FONT_UI1                   TRUE
 //    #define GDISP_INCLUDE_FONT_UI2                   TRUE		// The smallest preferred font.
 //    #define GDISP_INCLUDE_FONT_LARGENUMBERS          TRUE
 //    #define GDISP_INCLUDE_FONT_DEJAVUSANS10          TRUE
-//    #define GDISP_INCLUDE_FONT_DEJAVUSANS12          TRUE
+   #define GDISP_INCLUDE_FONT_DEJAVUSANS12          TRUE
 //    #define GDISP_INCLUDE_FONT_DEJAVUSANS16          TRUE
 //    #define GDISP_INCLUDE_FONT_DEJAVUSANS20          TRUE
 //    #define GDISP_INCLUDE_FONT_DEJAVUSANS24          TRUE
-   #define GDISP_INCLUDE_FONT_DEJAVUSANS32          TRUE
+//    #define GDISP_INCLUDE_FONT_DEJAVUSANS32          TRUE
 //    #define GDISP_INCLUDE_FONT_DEJAVUSANSBOLD12      TRUE
 //    #define GDISP_INCLUDE_FONT_FIXED_10X20           TRUE
 //    #define GDISP_INCLUDE_FONT_FIXED_7X14            TRUE
@@ -109,22 +116,22 @@
 //    #define GDISP_INCLUDE_FONT_DEJAVUSANS16_AA       TRUE
 //    #define GDISP_INCLUDE_FONT_DEJAVUSANS20_AA       TRUE
 //    #define GDISP_INCLUDE_FONT_DEJAVUSANS24_AA       TRUE
-//    #define GDISP_INCLUDE_FONT_DEJAVUSANS32_AA       TRUE
+   #define GDISP_INCLUDE_FONT_DEJAVUSANS32_AA       TRUE
 //    #define GDISP_INCLUDE_FONT_DEJAVUSANSBOLD12_AA   TRUE
 //    #define GDISP_INCLUDE_USER_FONTS                 FALSE
 
-// #define GDISP_NEED_IMAGE                            TRUE
-//    #define GDISP_NEED_IMAGE_NATIVE                  TRUE
+#define GDISP_NEED_IMAGE                             TRUE
+    #define GDISP_NEED_IMAGE_NATIVE                  TRUE
 //    #define GDISP_NEED_IMAGE_GIF                     TRUE
 //        #define GDISP_IMAGE_GIF_BLIT_BUFFER_SIZE     32
-//    #define GDISP_NEED_IMAGE_BMP                     TRUE
+    #define GDISP_NEED_IMAGE_BMP                     TRUE
 //        #define GDISP_NEED_IMAGE_BMP_1               TRUE
 //        #define GDISP_NEED_IMAGE_BMP_4               TRUE
 //        #define GDISP_NEED_IMAGE_BMP_4_RLE           TRUE
 //        #define GDISP_NEED_IMAGE_BMP_8               TRUE
 //        #define GDISP_NEED_IMAGE_BMP_8_RLE           TRUE
-//        #define GDISP_NEED_IMAGE_BMP_16              TRUE
-//        #define GDISP_NEED_IMAGE_BMP_24              TRUE
+        #define GDISP_NEED_IMAGE_BMP_16              TRUE
+        #define GDISP_NEED_IMAGE_BMP_24              TRUE
 //        #define GDISP_NEED_IMAGE_BMP_32              TRUE
 //        #define GDISP_IMAGE_BMP_BLIT_BUFFER_SIZE     32
 //    #define GDISP_NEED_IMAGE_JPG                     TRUE
@@ -148,8 +155,9 @@
 //        #define GDISP_IMAGE_PNG_FILE_BUFFER_SIZE     8
 //        #define GDISP_IMAGE_PNG_Z_BUFFER_SIZE        32768
    // #define GDISP_NEED_IMAGE_ACCOUNTING              TRUE
+    #define GDISP_NEED_IMAGE_FILECACHE               TRUE
 
-//#define GDISP_NEED_PIXMAP                            FALSE
+#define GDISP_NEED_PIXMAP                            TRUE
 //    #define GDISP_NEED_PIXMAP_IMAGE                  FALSE
 
 #define GDISP_DEFAULT_ORIENTATION                    GDISP_ROTATE_LANDSCAPE    // If not defined the native hardware orientation is used.
@@ -159,21 +167,32 @@
 
 #define GDISP_TOTAL_DISPLAYS                         1
 
-#define GDISP_DRIVER_LIST
+#define GDISP_DRIVER_LIST                            GDISPVMT_ST7789
    #ifdef GDISP_DRIVER_LIST
       // For code and speed optimization define as TRUE or FALSE if all controllers have the same capability
-      // #define GDISP_HARDWARE_STREAM_WRITE          FALSE
-      // #define GDISP_HARDWARE_STREAM_READ           FALSE
-      // #define GDISP_HARDWARE_STREAM_POS            FALSE
-      // #define GDISP_HARDWARE_DRAWPIXEL             FALSE
-      // #define GDISP_HARDWARE_CLEARS                FALSE
-      // #define GDISP_HARDWARE_FILLS                 FALSE
-      // #define GDISP_HARDWARE_BITFILLS              FALSE
-      // #define GDISP_HARDWARE_SCROLL                FALSE
-      // #define GDISP_HARDWARE_PIXELREAD             FALSE
-      // #define GDISP_HARDWARE_CONTROL               FALSE
-      // #define GDISP_HARDWARE_QUERY                 FALSE
-      // #define GDISP_HARDWARE_CLIP                  FALSE
+      // These follow the ST7789 driver, see drivers/gdisp/ST7789/gdisp_lld_config.h
+#ifdef CONFIG_LCD_RENDER_MODE_STRIP
+      #define GDISP_HARDWARE_FLUSH                  FALSE
+      #define GDISP_HARDWARE_STREAM_WRITE           TRUE
+      #define GDISP_HARDWARE_STREAM_READ            FALSE
+      #define GDISP_HARDWARE_FILLS                  FALSE
+      #define GDISP_HARDWARE_BITFILLS               FALSE
+      #define GDISP_HARDWARE_PIXELREAD              FALSE
+#else
+      #define GDISP_HARDWARE_FLUSH                  TRUE
+      #define GDISP_HARDWARE_STREAM_WRITE           TRUE
+      #define GDISP_HARDWARE_STREAM_READ            TRUE
+      #define GDISP_HARDWARE_FILLS                  TRUE
+      #define GDISP_HARDWARE_BITFILLS               TRUE
+      #define GDISP_HARDWARE_PIXELREAD              TRUE
+#endif
+      #define GDISP_HARDWARE_STREAM_POS             FALSE
+      #define GDISP_HARDWARE_DRAWPIXEL              FALSE
+      #define GDISP_HARDWARE_CLEARS                 FALSE
+      #define GDISP_HARDWARE_SCROLL                 FALSE
+      #define GDISP_HARDWARE_CONTROL                TRUE
+      #define GDISP_HARDWARE_QUERY                  FALSE
+      #define GDISP_HARDWARE_CLIP                   FALSE
 
       #define GDISP_PIXELFORMAT                     GDISP_PIXELFORMAT_RGB565
    #endif
@@ -257,7 +276,7 @@
 ///////////////////////////////////////////////////////////////////////////
 // GTIMER                                                                //
 ///////////////////////////////////////////////////////////////////////////
-#define GFX_USE_GTIMER                               TRUE
+// #define GFX_USE_GTIMER                               TRUE
 
 //#define GTIMER_THREAD_PRIORITY                       HIGH_PRIORITY
 //#define GTIMER_THREAD_WORKAREA_SIZE                  2048
@@ -301,7 +320,7 @@
 ///////////////////////////////////////////////////////////////////////////
 // GFILE                                                                 //
 ///////////////////////////////////////////////////////////////////////////
-// #define GFX_USE_GFILE                                TRUE
+#define GFX_USE_GFILE                                TRUE
 
 // #define GFILE_NEED_PRINTG                            TRUE
 // #define GFILE_NEED_SCANG                             TRUE
@@ -311,8 +330,9 @@
 // #define GFILE_NEED_NOAUTOMOUNT                       TRUE
 // #define GFILE_NEED_NOAUTOSYNC                        TRUE
 
-// #define GFILE_NEED_MEMFS                             TRUE
+#define GFILE_NEED_MEMFS                             TRUE
 //#define GFILE_NEED_ROMFS                             FALSE
+#define GFILE_NEED_MMAPFS                            TRUE
 //#define GFILE_NEED_RAMFS                             FALSE
 //#define GFILE_NEED_FATFS                             FALSE
 // #define GFILE_NEED_NATIVEFS                          TRUE
@@ -32,8 +32,8 @@ GDisplay	*GDISP;
 
 #if GDISP_NEED_MULTITHREAD
 	#define MUTEX_INIT(g)		gfxMutexInit(&(g)->mutex)
-	#define MUTEX_ENTER(g)		gfxMutexEnter(&(g)->mutex)
-	#define MUTEX_EXIT(g)		gfxMutexExit(&(g)->mutex)
+	#define MUTEX_ENTER(g)		do { if ((g)->batchowner != gfxThreadMe()) gfxMutexEnter(&(g)->mutex); } while (0)
+	#define MUTEX_EXIT(g)		do { if ((g)->batchowner != gfxThreadMe()) gfxMutexExit(&(g)->mutex); } while (0)
 	#define MUTEX_DEINIT(g)		gfxMutexDestroy(&(g)->mutex)
 #else
 	#define MUTEX_INIT(g)
@@ -89,7 +89,7 @@ GDisplay	*GDISP;
 #endif
 
 #if GDISP_HARDWARE_STREAM_POS && GDISP_HARDWARE_STREAM_WRITE
-	#define autoflush(g)									\
+	#define autoflush_batchdone(g)							\
 			{												\
 				if ((g->flags & GDISP_FLG_SCRSTREAM)) {		\
 					gdisp_lld_write_stop(g);				\
@@ -98,9 +98,16 @@ GDisplay	*GDISP;
 				autoflush_stopdone(g);						\
 			}
 #else
-	#define autoflush(g)		autoflush_stopdone(g)
+	#define autoflush_batchdone(g)	autoflush_stopdone(g)
 #endif
 
+// Inside a batch this is left to gdispGBatchEnd()
+#define autoflush(g)										\
+		{													\
+			if (!(g->flags & GDISP_FLG_BATCH))				\
+				autoflush_batchdone(g);						\
+		}
+
 // drawpixel(g)
 // Parameters:	x,y
 // Alters:		cx, cy (if using streaming)
@@ -731,6 +738,23 @@ void gdispGFlush(GDisplay *g) {
 	#endif
 }
 
+void gdispGBatchBegin(GDisplay *g) {
+	MUTEX_ENTER(g);
+	#if GDISP_NEED_MULTITHREAD
+		g->batchowner = gfxThreadMe();
+	#endif
+	g->flags |= GDISP_FLG_BATCH;
+}
+
+void gdispGBatchEnd(GDisplay *g) {
+	g->flags &= ~GDISP_FLG_BATCH;
+	autoflush(g);
+	#if GDISP_NEED_MULTITHREAD
+		g->batchowner = 0;
+	#endif
+	MUTEX_EXIT(g);
+}
+
 #if GDISP_NEED_STREAMING
 	void gdispGStreamStart(GDisplay *g, coord_t x, coord_t y, coord_t cx, coord_t cy) {
 		MUTEX_ENTER(g);
@@ -1107,7 +1131,7 @@ void gdispGBlitArea(GDisplay *g, coord_t x, coord_t y, coord_t cx, coord_t cy, c
 		{
 			// This is a different clipping to fillarea(g) as it needs to take into account srcx,srcy
 			if (x < g->clipx0) { cx -= g->clipx0 - x; srcx += g->clipx0 - x; x = g->clipx0; }
-			if (y < g->clipy0) { cy -= g->clipy0 - y; srcy += g->clipy0 - x; y = g->clipy0; }
+			if (y < g->clipy0) { cy -= g->clipy0 - y; srcy += g->clipy0 - y; y = g->clipy0; }
 			if (x+cx > g->clipx1)	cx = g->clipx1 - x;
 			if (y+cy > g->clipy1)	cy = g->clipy1 - y;
 			if (srcx+cx > srccx) cx = srccx - srcx;
@@ -3258,7 +3282,7 @@ void gdispGDrawBox(GDisplay *g, coord_t x, coord_t y, coord_t cx, coord_t cy, co
 #if GDISP_NEED_TEXT
 	#include "mcufont/mcufont.h"
 
-	#if GDISP_NEED_ANTIALIAS && GDISP_HARDWARE_PIXELREAD
+	#if GDISP_NEED_ANTIALIAS && GDISP_NEED_PIXELREAD && GDISP_HARDWARE_PIXELREAD
 		static void drawcharline(int16_t x, int16_t y, uint8_t count, uint8_t alpha, void *state) {
 			#define GD	((GDisplay *)state)
 			if (y < GD->t.clipy0 || y >= GD->t.clipy1 || x+count <= GD->t.clipx0 || x >= GD->t.clipx1)
@@ -3301,6 +3325,20 @@ void gdispGDrawBox(GDisplay *g, coord_t x, coord_t y, coord_t cx, coord_t cy, co
 	#endif
 
 	#if GDISP_NEED_ANTIALIAS
+		/* The fonts carry 4 bit alpha so the blends against a solid background can be made once per color pair.
+		 * A zeroed GDisplay already holds the valid palette for black on black.
+		 */
+		static void fillcharpal(GDisplay *g) {
+			uint8_t		i;
+
+			if (g->t.palcolor == g->t.color && g->t.palbgcolor == g->t.bgcolor)
+				return;
+			g->t.palcolor = g->t.color;
+			g->t.palbgcolor = g->t.bgcolor;
+			for (i = 0; i < 16; i++)
+				g->t.pal[i] = gdispBlendColor(g->t.color, g->t.bgcolor, i * 0x11);
+		}
+
 		static void fillcharline(int16_t x, int16_t y, uint8_t count, uint8_t alpha, void *state) {
 			#define GD	((GDisplay *)state)
 			if (y < GD->t.clipy0 || y >= GD->t.clipy1 || x+count <= GD->t.clipx0 || x >= GD->t.clipx1)
@@ -3314,13 +3352,14 @@ void gdispGDrawBox(GDisplay *g, coord_t x, coord_t y, coord_t cx, coord_t cy, co
 			if (alpha == 255) {
 				GD->p.color = GD->t.color;
 			} else {
-				GD->p.color = gdispBlendColor(GD->t.color, GD->t.bgcolor, alpha);
+				GD->p.color = GD->t.pal[alpha >> 4];
 			}
 			GD->p.x = x; GD->p.y = y; GD->p.x1 = x+count-1;
 			hline_clip(GD);
 			#undef GD
 		}
 	#else
+		#define fillcharpal(g)
 		#define fillcharline	drawcharline
 	#endif
 
@@ -3331,9 +3370,40 @@ void gdispGDrawBox(GDisplay *g, coord_t x, coord_t y, coord_t cx, coord_t cy, co
 		#undef GD
 	}
 
+	#if GDISP_HARDWARE_FILLS
+		/* Span sink for glyphs already known to be inside both clip areas. */
+		static void fillcharspan(int16_t x, int16_t y, uint8_t count, uint8_t alpha, void *state) {
+			#define GD	((GDisplay *)state)
+			#if GDISP_NEED_ANTIALIAS
+				GD->p.color = alpha == 255 ? GD->t.color : GD->t.pal[alpha >> 4];
+			#else
+				if (alpha <= 0x80)
+					return;
+				GD->p.color = GD->t.color;
+			#endif
+			GD->p.x = x; GD->p.y = y; GD->p.cx = count; GD->p.cy = 1;
+			gdisp_lld_fill_area(GD);
+			#undef GD
+		}
+	#endif
+
 	/* Callback to render characters. */
 	static uint8_t fillcharglyph(int16_t x, int16_t y, mf_char ch, void *state) {
 		#define GD	((GDisplay *)state)
+			#if GDISP_HARDWARE_FILLS
+				// Clip the glyph box once instead of every span
+				#if GDISP_HARDWARE_FILLS == HARDWARE_AUTODETECT
+					if (gvmt(GD)->fill)
+				#endif
+				if (x >= GD->t.clipx0 && y >= GD->t.clipy0
+						&& x + GD->t.font->width <= GD->t.clipx1 && y + GD->t.font->height <= GD->t.clipy1
+					#if NEED_CLIPPING
+						&& x >= GD->clipx0 && y >= GD->clipy0
+						&& x + GD->t.font->width <= GD->clipx1 && y + GD->t.font->height <= GD->clipy1
+					#endif
+					)
+					return mf_render_character(GD->t.font, x, y, ch, fillcharspan, state);
+			#endif
 			return mf_render_character(GD->t.font, x, y, ch, fillcharline, state);
 		#undef GD
 	}
@@ -3391,6 +3461,7 @@ void gdispGDrawBox(GDisplay *g, coord_t x, coord_t y, coord_t cx, coord_t cy, co
 		g->t.clipy1 = g->p.y+g->p.cy;
 		g->t.color = color;
 		g->t.bgcolor = g->p.color = bgcolor;
+		fillcharpal(g);
 
 		TEST_CLIP_AREA(g) {
 			fillarea(g);
@@ -3429,6 +3500,7 @@ void gdispGDrawBox(GDisplay *g, coord_t x, coord_t y, coord_t cx, coord_t cy, co
 		g->t.clipy1 = g->p.y+g->p.cy;
 		g->t.color = color;
 		g->t.bgcolor = g->p.color = bgcolor;
+		fillcharpal(g);
 
 		TEST_CLIP_AREA(g) {
 			fillarea(g);
@@ -3592,6 +3664,7 @@ void gdispGDrawBox(GDisplay *g, coord_t x, coord_t y, coord_t cx, coord_t cy, co
 			g->t.font = font;
 			g->t.color = color;
 			g->t.bgcolor = bgcolor;
+			fillcharpal(g);
 			#if GDISP_NEED_TEXT_WORDWRAP
 				if (!(justify & justifyNoWordWrap)) {
 					g->t.lrj = (justify & JUSTIFYMASK_LEFTRIGHT);
@@ -388,6 +388,31 @@ uint8_t gdispGGetContrast(GDisplay *g);
 void gdispGFlush(GDisplay *g);
 #define gdispFlush()									gdispGFlush(GDISP)
 
+/**
+ * @brief   Start a batch of drawing operations
+ * @details	The display lock is taken once and held until @p gdispGBatchEnd().
+ * 			Drawing calls made by the same thread in between skip the lock and
+ * 			any auto-flush, other threads wait until the batch is complete.
+ * @note	Batches may not be nested.
+ *
+ * @param[in] g 	The display to use
+ *
+ * @api
+ */
+void gdispGBatchBegin(GDisplay *g);
+#define gdispBatchBegin()								gdispGBatchBegin(GDISP)
+
+/**
+ * @brief   End a batch of drawing operations
+ * @details	Runs the deferred auto-flush (if any) and releases the display lock.
+ *
+ * @param[in] g 	The display to use
+ *
+ * @api
+ */
+void gdispGBatchEnd(GDisplay *g);
+#define gdispBatchEnd()									gdispGBatchEnd(GDISP)
+
 /**
  * @brief   Clear the display to the specified color.
  *
@@ -242,6 +242,14 @@
 		#undef GDISP_HARDWARE_CONTROL
 		#define GDISP_HARDWARE_CONTROL		HARDWARE_AUTODETECT
 	#endif
+	#if !GDISP_HARDWARE_FILLS
+		#undef GDISP_HARDWARE_FILLS
+		#define GDISP_HARDWARE_FILLS		HARDWARE_AUTODETECT
+	#endif
+	#if !GDISP_HARDWARE_BITFILLS
+		#undef GDISP_HARDWARE_BITFILLS
+		#define GDISP_HARDWARE_BITFILLS		HARDWARE_AUTODETECT
+	#endif
 	#if GDISP_HARDWARE_FLUSH == TRUE
 		#undef GDISP_HARDWARE_FLUSH
 		#define GDISP_HARDWARE_FLUSH		HARDWARE_AUTODETECT
@@ -258,14 +266,6 @@
 		#undef GDISP_HARDWARE_CLEARS
 		#define GDISP_HARDWARE_CLEARS		HARDWARE_AUTODETECT
 	#endif
-	#if GDISP_HARDWARE_FILLS == TRUE
-		#undef GDISP_HARDWARE_FILLS
-		#define GDISP_HARDWARE_FILLS		HARDWARE_AUTODETECT
-	#endif
-	#if GDISP_HARDWARE_BITFILLS == TRUE
-		#undef GDISP_HARDWARE_BITFILLS
-		#define GDISP_HARDWARE_BITFILLS		HARDWARE_AUTODETECT
-	#endif
 	#if GDISP_HARDWARE_SCROLL == TRUE
 		#undef GDISP_HARDWARE_SCROLL
 		#define GDISP_HARDWARE_SCROLL		HARDWARE_AUTODETECT
@@ -334,11 +334,13 @@ struct GDisplay {
 	uint16_t					flags;
 		#define GDISP_FLG_INSTREAM		0x0001		// We are in a user based stream operation
 		#define GDISP_FLG_SCRSTREAM		0x0002		// The stream area currently covers the whole screen
-		#define GDISP_FLG_DRIVER		0x0004		// This flags and above are for use by the driver
+		#define GDISP_FLG_BATCH			0x0004		// We are in a batch of drawing operations
+		#define GDISP_FLG_DRIVER		0x0008		// This flags and above are for use by the driver
 
 	// Multithread Mutex
 	#if GDISP_NEED_MULTITHREAD
 		gfxMutex				mutex;
+		gfxThreadHandle			batchowner;			// The thread holding the mutex for a batch
 	#endif
 
 	// Software clipping
@@ -371,6 +373,10 @@ struct GDisplay {
 				coord_t		wrapx, wrapy;
 				justify_t	lrj;
 			#endif
+			#if GDISP_NEED_ANTIALIAS
+				color_t		palcolor, palbgcolor;
+				color_t		pal[16];			// color blended over bgcolor for each 4 bit alpha level
+			#endif
 		} t;
 	#endif
 	#if GDISP_LINEBUF_SIZE != 0 && ((GDISP_NEED_SCROLL && !GDISP_HARDWARE_SCROLL) || (!GDISP_HARDWARE_STREAM_WRITE && GDISP_HARDWARE_BITFILLS))
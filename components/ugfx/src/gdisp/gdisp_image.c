@@ -170,6 +170,64 @@ gdispImageError gdispImageCache(gdispImage *img) {
 	return img->fns->cache(img);
 }
 
+#if GDISP_NEED_IMAGE_FILECACHE
+	#include <string.h>
+
+	typedef struct imageFileCache {
+		gdispImage		img;
+		char			name[32];
+		uint32_t		used;					// When the image was last opened, 0 if the slot is free
+	} imageFileCache;
+
+	static imageFileCache	ImageFileCache[GDISP_IMAGE_FILECACHE_SIZE];
+	static uint32_t			ImageFileCacheTick;
+
+	gdispImage *gdispImageCacheOpen(const char *filename) {
+		imageFileCache *p, *slot;
+
+		if (!filename || strlen(filename) >= sizeof(ImageFileCache[0].name))
+			return 0;
+
+		// Look for the file, remembering a free or the least recently used slot as we go
+		for(p = slot = ImageFileCache; p < ImageFileCache+GDISP_IMAGE_FILECACHE_SIZE; p++) {
+			if (p->used && !strcmp(p->name, filename)) {
+				p->used = ++ImageFileCacheTick;
+				return &p->img;
+			}
+			if (p->used < slot->used)
+				slot = p;
+		}
+
+		// Evict whatever is in the slot
+		if (slot->used) {
+			gdispImageClose(&slot->img);
+			slot->used = 0;
+		}
+
+		gdispImageInit(&slot->img);
+		if ((gdispImageOpenFile(&slot->img, filename) & GDISP_IMAGE_ERR_UNRECOVERABLE))
+			return 0;
+
+		// A failure here only means the image is decoded on every draw
+		gdispImageCache(&slot->img);
+
+		strcpy(slot->name, filename);
+		slot->used = ++ImageFileCacheTick;
+		return &slot->img;
+	}
+
+	void gdispImageCacheFlush(void) {
+		imageFileCache *p;
+
+		for(p = ImageFileCache; p < ImageFileCache+GDISP_IMAGE_FILECACHE_SIZE; p++) {
+			if (p->used) {
+				gdispImageClose(&p->img);
+				p->used = 0;
+			}
+		}
+	}
+#endif
+
 gdispImageError gdispGImageDraw(GDisplay *g, gdispImage *img, coord_t x, coord_t y, coord_t cx, coord_t cy, coord_t sx, coord_t sy) {
 	if (!img) return GDISP_IMAGE_ERR_NULLPOINTER;
 	if (!img->fns) return GDISP_IMAGE_ERR_BADFORMAT;
@@ -182,6 +240,13 @@ gdispImageError gdispGImageDraw(GDisplay *g, gdispImage *img, coord_t x, coord_t
 	if (sx + cx > img->width)  cx = img->width - sx;
 	if (sy + cy > img->height) cy = img->height - sy;
 
+	// Trim the lines and columns that fall off the display so the decoder can skip them
+	if (x < 0) { cx += x; sx -= x; x = 0; }
+	if (y < 0) { cy += y; sy -= y; y = 0; }
+	if (x + cx > gdispGGetWidth(g))  cx = gdispGGetWidth(g) - x;
+	if (y + cy > gdispGGetHeight(g)) cy = gdispGGetHeight(g) - y;
+	if (cx <= 0 || cy <= 0) return GDISP_IMAGE_ERR_OK;
+
 	// Draw
 	return img->fns->draw(g, img, x, y, cx, cy, sx, sy);
 }
@@ -216,7 +281,7 @@ void *gdispImageAlloc(gdispImage *img, size_t sz) {
 	#if GDISP_NEED_IMAGE_ACCOUNTING
 		void *ptr;
 
-		ptr = gfxAlloc(sz);
+		ptr = gfxAllocCaps(sz, GFX_ALLOC_SPIRAM);
 		if (ptr) {
 			img->memused += sz;
 			if (img->memused > img->maxmemused)
@@ -225,7 +290,7 @@ void *gdispImageAlloc(gdispImage *img, size_t sz) {
 		return ptr;
 	#else
 		(void) img;
-		return gfxAlloc(sz);
+		return gfxAllocCaps(sz, GFX_ALLOC_SPIRAM);
 	#endif
 }
 
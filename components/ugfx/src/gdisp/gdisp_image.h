@@ -206,6 +206,30 @@ extern "C" {
 	 */
 	gdispImageError gdispImageCache(gdispImage *img);
 
+	#if GDISP_NEED_IMAGE_FILECACHE || defined(__DOXYGEN__)
+		/**
+		 * @brief	Open an image file through the image file cache
+		 * @return	The cached image or NULL if the file cannot be opened
+		 *
+		 * @param[in] filename	The image file name
+		 *
+		 * @note	The first call for a file opens it and decodes the first frame into RAM with
+		 * 			@p gdispImageCache(). Later calls return the same image so drawing it is a blit.
+		 * @note	If there is not enough RAM to cache the frame the image is still returned and
+		 * 			is decoded each time it is drawn.
+		 * @note	The image belongs to the cache. Do not close it. It stays valid until it is
+		 * 			evicted by opening more than GDISP_IMAGE_FILECACHE_SIZE other files or until
+		 * 			@p gdispImageCacheFlush() is called.
+		 * @note	The cache is not thread-safe. Use it from a single drawing thread.
+		 */
+		gdispImage *gdispImageCacheOpen(const char *filename);
+
+		/**
+		 * @brief	Close all the images held by the image file cache
+		 */
+		void gdispImageCacheFlush(void);
+	#endif
+
 	/**
 	 * @brief	Draw the image
 	 * @return	GDISP_IMAGE_ERR_OK (0) on success or an error code.
@@ -751,7 +751,7 @@ gdispImageError gdispImageCache_BMP(gdispImage *img) {
 
 gdispImageError gdispGImageDraw_BMP(GDisplay *g, gdispImage *img, coord_t x, coord_t y, coord_t cx, coord_t cy, coord_t sx, coord_t sy) {
 	gdispImagePrivate_BMP *	priv;
-	coord_t				mx, my;
+	coord_t				mx, my, my0;
 	coord_t				pos, len, st;
 
 	priv = (gdispImagePrivate_BMP *)img->priv;
@@ -767,15 +767,21 @@ gdispImageError gdispGImageDraw_BMP(GDisplay *g, gdispImage *img, coord_t x, coo
 		return GDISP_IMAGE_ERR_OK;
 	}
 
-	/* Start decoding from the beginning */
-	gfileSetPos(img->f, priv->frame0pos);
+	/* Lines past the region are never decoded. Uncompressed lines have a fixed 32 bit aligned
+	 * stride so the lines before the region are skipped with a seek rather than decoded. */
+	my0 = 0;
+#if GDISP_NEED_IMAGE_BMP_4_RLE || GDISP_NEED_IMAGE_BMP_8_RLE
+	if (!(priv->bmpflags & BMP_COMP_RLE))
+#endif
+		my0 = (priv->bmpflags & BMP_TOP_TO_BOTTOM) ? sy : img->height - (sy+cy);
+	gfileSetPos(img->f, priv->frame0pos + (size_t)my0 * ((((size_t)img->width * priv->bitsperpixel + 31) >> 5) << 2));
 #if GDISP_NEED_IMAGE_BMP_4_RLE || GDISP_NEED_IMAGE_BMP_8_RLE
 	priv->rlerun = 0;
 	priv->rlecode = 0;
 #endif
 
 	if (priv->bmpflags & BMP_TOP_TO_BOTTOM) {
-		for(my = 0; my < img->height; my++) {
+		for(my = my0; my < sy+cy; my++) {
 			mx = 0;
 			while(mx < img->width) {
 				if (!(pos = getPixels(img, mx)))
@@ -793,7 +799,7 @@ gdispImageError gdispGImageDraw_BMP(GDisplay *g, gdispImage *img, coord_t x, coo
 			}
 		}
 	} else {
-		for(my = img->height-1; my >= 0; my--) {
+		for(my = img->height-1-my0; my >= sy; my--) {
 			mx = 0;
 			while(mx < img->width) {
 				if (!(pos = getPixels(img, mx)))
@@ -325,6 +325,22 @@
 	#ifndef GDISP_NEED_IMAGE_ACCOUNTING
 		#define GDISP_NEED_IMAGE_ACCOUNTING		FALSE
 	#endif
+	/**
+	 * @brief   Keep decoded images open and cached by file name.
+	 * @details	Defaults to FALSE
+	 * @note	Adds @p gdispImageCacheOpen() and @p gdispImageCacheFlush().
+	 */
+	#ifndef GDISP_NEED_IMAGE_FILECACHE
+		#define GDISP_NEED_IMAGE_FILECACHE		FALSE
+	#endif
+	/**
+	 * @brief   The number of images held by the file cache.
+	 * @details	Defaults to 4
+	 * @note	The least recently used image is closed when a new one needs a slot.
+	 */
+	#ifndef GDISP_IMAGE_FILECACHE_SIZE
+		#define GDISP_IMAGE_FILECACHE_SIZE		4
+	#endif
 /**
  * @}
  *
@@ -606,6 +622,13 @@
 	#ifndef GDISP_NEED_TEXT_KERNING
 		#define GDISP_NEED_TEXT_KERNING			FALSE
 	#endif
+	/**
+	 * @brief	Cache character and string widths in RAM.
+	 * @details	Defaults to FALSE
+	 */
+	#ifndef GDISP_NEED_TEXT_WIDTHCACHE
+		#define GDISP_NEED_TEXT_WIDTHCACHE		FALSE
+	#endif
 	/**
 	 * @brief	Enable antialiased font support
 	 * @details	Defaults to FALSE
@@ -613,6 +636,16 @@
 	#ifndef GDISP_NEED_ANTIALIAS
 		#define GDISP_NEED_ANTIALIAS			FALSE
 	#endif
+	/**
+	 * @brief	Anti-aliased text is only ever drawn filled
+	 * @details	Defaults to FALSE
+	 * @note	Filled text blends against its background color and needs no pixel read back.
+	 * 			Set this on displays that cannot read back pixels when unfilled text drawing
+	 * 			its glyphs solid is expected.
+	 */
+	#ifndef GDISP_ANTIALIAS_FILLED_ONLY
+		#define GDISP_ANTIALIAS_FILLED_ONLY		FALSE
+	#endif
 /**
  * @}
  *
@@ -27,12 +27,18 @@
 #undef GDISP_HARDWARE_CLIP
 #define GDISP_HARDWARE_DEINIT			TRUE
 #define GDISP_HARDWARE_DRAWPIXEL		TRUE
+#define GDISP_HARDWARE_FILLS			TRUE
+#define GDISP_HARDWARE_BITFILLS			TRUE
 #define GDISP_HARDWARE_PIXELREAD		TRUE
 #define GDISP_HARDWARE_CONTROL			TRUE
 #define IN_PIXMAP_DRIVER				TRUE
 #define GDISP_DRIVER_VMT				GDISPVMT_pixmap
 #define GDISP_DRIVER_VMT_FLAGS			(GDISP_VFLG_DYNAMICONLY|GDISP_VFLG_PIXMAP)
 
+// The pixmap surface uses the system pixel format
+#undef GDISP_LLD_PIXELFORMAT
+#define GDISP_LLD_PIXELFORMAT			GDISP_PIXELFORMAT
+
 // This pseudo driver currently only supports unpacked formats with more than 8 bits per pixel
 //	that is, we only support GRAY_SCALE and PALETTE with 8 bits per pixel or any unpacked TRUE_COLOR format.
 #if (GDISP_LLD_PIXELFORMAT & GDISP_COLORSYSTEM_GRAYSCALE) && (GDISP_LLD_PIXELFORMAT & 0xFF) != 8
@@ -42,6 +48,8 @@
 #include "gdisp_driver.h"
 #include "../gdriver/gdriver.h"
 
+#include <string.h>
+
 typedef struct pixmap {
 	#if GDISP_NEED_PIXMAP_IMAGE
 		uint8_t		imghdr[8];			// This field must come just before the data member.
@@ -60,7 +68,7 @@ GDisplay *gdispPixmapCreate(coord_t width, coord_t height) {
 		i = 2*sizeof(coord_t);
 
 	// Allocate the pixmap
-	if (!(p = gfxAlloc(i+sizeof(pixmap)-sizeof(p->pixels))))
+	if (!(p = gfxAllocCaps(i+sizeof(pixmap)-sizeof(p->pixels), GFX_ALLOC_SPIRAM)))
 		return 0;
 
 	// Fill in the image header (if required)
@@ -185,6 +193,64 @@ LLDSPEC	color_t gdisp_lld_get_pixel_color(GDisplay *g) {
 	return ((pixmap *)(g)->priv)->pixels[pos];
 }
 
+// Get the surface position of x,y and the position steps to the next pixel and the next line
+static unsigned pixmap_pos(GDisplay *g, coord_t x, coord_t y, int *dx, int *dy) {
+	#if GDISP_NEED_CONTROL
+		switch(g->g.Orientation) {
+		case GDISP_ROTATE_0:
+		default:
+			break;
+		case GDISP_ROTATE_90:
+			*dx = -g->g.Height;
+			*dy = 1;
+			return (g->g.Width-x-1) * g->g.Height + y;
+		case GDISP_ROTATE_180:
+			*dx = -1;
+			*dy = -g->g.Width;
+			return (g->g.Height-y-1) * g->g.Width + g->g.Width-x-1;
+		case GDISP_ROTATE_270:
+			*dx = g->g.Height;
+			*dy = -1;
+			return x * g->g.Height + g->g.Height-y-1;
+		}
+	#endif
+
+	*dx = 1;
+	*dy = g->g.Width;
+	return y * g->g.Width + x;
+}
+
+LLDSPEC void gdisp_lld_fill_area(GDisplay *g) {
+	color_t		*p, *q;
+	coord_t		x, y;
+	int			dx, dy;
+
+	p = ((pixmap *)(g)->priv)->pixels + pixmap_pos(g, g->p.x, g->p.y, &dx, &dy);
+	for(y = 0; y < g->p.cy; y++, p += dy) {
+		for(x = 0, q = p; x < g->p.cx; x++, q += dx)
+			*q = g->p.color;
+	}
+}
+
+LLDSPEC void gdisp_lld_blit_area(GDisplay *g) {
+	const pixel_t	*src;
+	color_t			*p, *q;
+	coord_t			x, y;
+	int				dx, dy;
+
+	src = (const pixel_t *)g->p.ptr + g->p.y1 * g->p.x2 + g->p.x1;
+	p = ((pixmap *)(g)->priv)->pixels + pixmap_pos(g, g->p.x, g->p.y, &dx, &dy);
+	for(y = 0; y < g->p.cy; y++, p += dy, src += g->p.x2) {
+		// Unrotated lines are plain copies
+		if (dx == 1) {
+			memcpy(p, src, g->p.cx * sizeof(pixel_t));
+			continue;
+		}
+		for(x = 0, q = p; x < g->p.cx; x++, q += dx)
+			*q = src[x];
+	}
+}
+
 #if GDISP_NEED_CONTROL
 	LLDSPEC void gdisp_lld_control(GDisplay *g) {
 		switch(g->p.x) {
@@ -76,7 +76,7 @@
 			#endif
 			#undef GDISP_NEED_PIXELREAD
 			#define GDISP_NEED_PIXELREAD	TRUE
-		#else
+		#elif !GDISP_ANTIALIAS_FILLED_ONLY
 			#if GFX_DISPLAY_RULE_WARNINGS
 				#if GFX_COMPILER_WARNING_TYPE == GFX_COMPILER_WARNING_DIRECT
 					#warning "GDISP: GDISP_NEED_ANTIALIAS has been set but your hardware does not support reading back pixels. Anti-aliasing will only occur for filled characters."
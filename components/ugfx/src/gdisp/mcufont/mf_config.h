@@ -37,6 +37,7 @@
 #endif
 
 #define MF_USE_KERNING GDISP_NEED_TEXT_KERNING
+#define MF_USE_WIDTH_CACHE GDISP_NEED_TEXT_WIDTHCACHE
 #define MF_FONT_FILE_NAME "src/gdisp/fonts/fonts.h"
 
 /* These are not used for now */
@@ -149,6 +150,23 @@
 #define MF_USE_TABS 1
 #endif
 
+/* Enable or disable the character width cache.
+ * If enabled, the widths of printable ASCII characters are kept in RAM for
+ * the first MF_WIDTH_CACHE_FONTS fonts used, and the widths of the last
+ * MF_STRING_CACHE_SIZE kerned strings are remembered.
+ */
+#ifndef MF_USE_WIDTH_CACHE
+#define MF_USE_WIDTH_CACHE 0
+#endif
+
+#ifndef MF_WIDTH_CACHE_FONTS
+#define MF_WIDTH_CACHE_FONTS 4
+#endif
+
+#ifndef MF_STRING_CACHE_SIZE
+#define MF_STRING_CACHE_SIZE 8
+#endif
+
 /* Number of vertical zones to use when computing kerning.
  * Larger values give more accurate kerning, but are slower and use somewhat
  * more memory. There is no point to increase this beyond the height of the
@@ -44,11 +44,61 @@ uint8_t mf_render_character(const struct mf_font_s *font,
     return width;
 }
 
-uint8_t mf_character_width(const struct mf_font_s *font,
-                           mf_char character)
+#if MF_USE_WIDTH_CACHE
+#define MF_WIDTH_CACHE_FIRST 0x20
+#define MF_WIDTH_CACHE_LAST  0x7E
+#define MF_WIDTH_CACHE_EMPTY 0xFF
+
+struct mf_width_cache_s
+{
+    const struct mf_font_s *font;
+    uint8_t width[MF_WIDTH_CACHE_LAST - MF_WIDTH_CACHE_FIRST + 1];
+};
+
+static struct mf_width_cache_s mf_width_cache[MF_WIDTH_CACHE_FONTS];
+static portMUX_TYPE mf_width_cache_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/* Find the width table of a font, claiming a free one on first use.
+ * Slots are never given back, so a table stays with its font for good. */
+static uint8_t *mf_width_cache_get(const struct mf_font_s *font)
+{
+    uint8_t *result = 0;
+    uint8_t i, j;
+    
+    for (i = 0; i < MF_WIDTH_CACHE_FONTS; i++)
+    {
+        if (mf_width_cache[i].font == font)
+            return mf_width_cache[i].width;
+    }
+    
+    gfxSystemLock(&mf_width_cache_mux);
+    for (i = 0; i < MF_WIDTH_CACHE_FONTS; i++)
+    {
+        if (mf_width_cache[i].font == font)
+        {
+            result = mf_width_cache[i].width;
+            break;
+        }
+        if (!mf_width_cache[i].font)
+        {
+            for (j = 0; j < sizeof(mf_width_cache[i].width); j++)
+                mf_width_cache[i].width[j] = MF_WIDTH_CACHE_EMPTY;
+            mf_width_cache[i].font = font;
+            result = mf_width_cache[i].width;
+            break;
+        }
+    }
+    gfxSystemUnlock(&mf_width_cache_mux);
+    
+    return result;
+}
+#endif
+
+static uint8_t mf_character_width_uncached(const struct mf_font_s *font,
+                                           uint16_t character)
 {
     uint8_t width;
-    width = font->character_width(font, MFCHAR2UINT16(character));
+    width = font->character_width(font, character);
     
     if (!width)
     {
@@ -58,6 +108,31 @@ uint8_t mf_character_width(const struct mf_font_s *font,
     return width;
 }
 
+uint8_t mf_character_width(const struct mf_font_s *font,
+                           mf_char character)
+{
+    uint16_t c = MFCHAR2UINT16(character);
+    
+#if MF_USE_WIDTH_CACHE
+    if (c >= MF_WIDTH_CACHE_FIRST && c <= MF_WIDTH_CACHE_LAST)
+    {
+        uint8_t *table = mf_width_cache_get(font);
+        if (table)
+        {
+            uint8_t width = table[c - MF_WIDTH_CACHE_FIRST];
+            if (width == MF_WIDTH_CACHE_EMPTY)
+            {
+                width = mf_character_width_uncached(font, c);
+                table[c - MF_WIDTH_CACHE_FIRST] = width;
+            }
+            return width;
+        }
+    }
+#endif
+    
+    return mf_character_width_uncached(font, c);
+}
+
 /* Avoids a dependency on libc */
 static bool strequals(const char *a, const char *b)
 {
@@ -48,15 +48,102 @@ static int16_t mf_round_to_prev_tab(const struct mf_font_s *font,
 }
 #endif
 
-int16_t mf_get_string_width(const struct mf_font_s *font, mf_str text,
-                            uint16_t count, bool kern)
+#if MF_USE_WIDTH_CACHE && MF_USE_KERNING && (MF_ENCODING == MF_ENCODING_ASCII || MF_ENCODING == MF_ENCODING_UTF8)
+#define MF_STRING_CACHE_LEN 15
+
+/* Kerning walks the glyph outlines of every character pair, so remember the
+ * widths of recent short strings. */
+struct mf_string_cache_s
+{
+    const struct mf_font_s *font;
+    int16_t width;
+    char text[MF_STRING_CACHE_LEN + 1];
+};
+
+static struct mf_string_cache_s mf_string_cache[MF_STRING_CACHE_SIZE];
+static uint8_t mf_string_cache_next = 0;
+static portMUX_TYPE mf_string_cache_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/* The key holds the bytes of the first count characters, which with UTF-8 may
+ * be more than count bytes. */
+static bool mf_string_cache_key(mf_str text, uint16_t count, char *key)
+{
+    mf_str next;
+    uint16_t len = 0;
+    
+    while (count-- && *text)
+    {
+        next = text;
+        mf_getchar(&next);
+        
+        /* Only strings that fit entirely are cached */
+        if (len + (next - text) > MF_STRING_CACHE_LEN)
+            return false;
+        
+        while (text < next)
+            key[len++] = *text++;
+    }
+    key[len] = 0;
+    
+    return true;
+}
+
+static bool mf_string_cache_equals(const char *a, const char *b)
+{
+    while (*a)
+    {
+        if (*a++ != *b++)
+            return false;
+    }
+    return !*b;
+}
+
+static bool mf_string_cache_find(const struct mf_font_s *font, const char *key,
+                                 int16_t *width)
+{
+    bool found = false;
+    uint8_t i;
+    
+    gfxSystemLock(&mf_string_cache_mux);
+    for (i = 0; i < MF_STRING_CACHE_SIZE; i++)
+    {
+        if (mf_string_cache[i].font == font &&
+            mf_string_cache_equals(mf_string_cache[i].text, key))
+        {
+            *width = mf_string_cache[i].width;
+            found = true;
+            break;
+        }
+    }
+    gfxSystemUnlock(&mf_string_cache_mux);
+    
+    return found;
+}
+
+static void mf_string_cache_put(const struct mf_font_s *font, const char *key,
+                                int16_t width)
+{
+    struct mf_string_cache_s *entry;
+    uint8_t i;
+    
+    gfxSystemLock(&mf_string_cache_mux);
+    entry = &mf_string_cache[mf_string_cache_next];
+    mf_string_cache_next = (mf_string_cache_next + 1) % MF_STRING_CACHE_SIZE;
+    entry->font = font;
+    entry->width = width;
+    for (i = 0; key[i]; i++)
+        entry->text[i] = key[i];
+    entry->text[i] = 0;
+    gfxSystemUnlock(&mf_string_cache_mux);
+}
+#endif
+
+static int16_t mf_get_string_width_uncached(const struct mf_font_s *font, mf_str text,
+                                            uint16_t count, bool kern)
 {
     int16_t result = 0;
     uint16_t c1 = 0, c2;
     
-    if (!count)
-        count = 0xFFFF;
-    
     while (count-- && *text)
     {
         c2 = mf_getchar(&text);
@@ -82,6 +169,34 @@ int16_t mf_get_string_width(const struct mf_font_s *font, mf_str text,
     return result;
 }
 
+int16_t mf_get_string_width(const struct mf_font_s *font, mf_str text,
+                            uint16_t count, bool kern)
+{
+    if (!count)
+        count = 0xFFFF;
+    
+#if MF_USE_WIDTH_CACHE && MF_USE_KERNING && (MF_ENCODING == MF_ENCODING_ASCII || MF_ENCODING == MF_ENCODING_UTF8)
+    if (kern)
+    {
+        char key[MF_STRING_CACHE_LEN + 1];
+        int16_t result;
+        
+        if (!mf_string_cache_key(text, count, key))
+            return mf_get_string_width_uncached(font, text, count, kern);
+        
+        if (!mf_string_cache_find(font, key, &result))
+        {
+            result = mf_get_string_width_uncached(font, text, count, kern);
+            mf_string_cache_put(font, key, result);
+        }
+        
+        return result;
+    }
+#endif
+    
+    return mf_get_string_width_uncached(font, text, count, kern);
+}
+
 /* Return the length of the string without trailing spaces. */
 static uint16_t strip_spaces(mf_str text, uint16_t count, mf_char *last_char)
 {
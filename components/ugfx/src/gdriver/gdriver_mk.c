@@ -6,8 +6,3 @@
  */
 
 #include "gdriver.c"
-
-#undef GDISP_DRIVER_LIST
-
-#define GDISP_DRIVER_LIST GDISPVMT_ST7789
-#include "drivers/gdisp/ST7789/gdisp_lld_ST7789.c"
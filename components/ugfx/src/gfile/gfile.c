@@ -31,6 +31,9 @@
 #if GFILE_NEED_RAMFS
 	extern const GFILEVMT FsRAMVMT;
 #endif
+#if GFILE_NEED_MMAPFS
+	extern const GFILEVMT FsMmapVMT;
+#endif
 
 
 /**
@@ -53,6 +56,9 @@ static const GFILEVMT * FsArray[] = {
 	#if GFILE_NEED_RAMFS
 		&FsRAMVMT,
 	#endif
+	#if GFILE_NEED_MMAPFS
+		&FsMmapVMT,
+	#endif
 };
 
 /*
@@ -71,6 +77,10 @@ void _gfileInit(void) {
 		extern void _gfileNativeAssignStdio(void);
 		_gfileNativeAssignStdio();
 	#endif
+	#if GFILE_NEED_MMAPFS
+		extern void _gfileMmapInit(void);
+		_gfileMmapInit();
+	#endif
 }
 
 void _gfileDeinit(void)
@@ -343,6 +343,24 @@ extern "C" {
 		GFILE *		gfileOpenMemory(void *memptr, const char *mode);
 	#endif
 
+	#if GFILE_NEED_MMAPFS || defined(__DOXYGEN__)
+		/**
+		 * @brief					Get a pointer to a file on the memory-mapped flash partition
+		 *
+		 * @param[in] fname			The file name (without any "A|" prefix)
+		 * @param[out] psize		Where to store the file size. May be NULL.
+		 *
+		 * @return					The file data mapped in place, 0 if the file does not exist
+		 *
+		 * @note					The pointer stays valid for the lifetime of the application. The data
+		 * 							is read-only and sits in the flash data cache so it can be passed
+		 * 							directly to anything that takes a memory pointer eg. @p gfileOpenMemory().
+		 *
+		 * @api
+		 */
+		const void *gfileMmapPointer(const char *fname, long int *psize);
+	#endif
+
 	#if GFILE_NEED_STRINGS || defined(__DOXYGEN__)
 		/**
 		 * @brief					Open file from a null terminated C string
@@ -0,0 +1,212 @@
+/*
+ * This file is subject to the terms of the GFX License. If a copy of
+ * the license was not distributed with this file, you can obtain one at:
+ *
+ *              http://ugfx.org/license.html
+ */
+
+/********************************************************
+ * The memory-mapped flash partition file-system
+ ********************************************************/
+
+#include "../../gfx.h"
+
+#if GFX_USE_GFILE && GFILE_NEED_MMAPFS
+
+#include "gfile_fs.h"
+
+#include <string.h>
+
+#include "esp_partition.h"
+
+// The image layout written by tools/pack_assets.py (all fields little-endian)
+#define MMAPFS_MAGIC				0x41465547		// "GUFA"
+#define MMAPFS_VER_MAX				0x0001
+#define MMAPFS_NAME_LEN				24
+
+typedef struct MMAPFS_HEADER {
+	uint32_t						magic;			// MMAPFS_MAGIC
+	uint16_t						ver;			// Image format version
+	uint16_t						count;			// Number of directory entries
+	uint32_t						size;			// Total image size including the header
+} MMAPFS_HEADER;
+
+typedef struct MMAPFS_DIRENTRY {
+	char							name[MMAPFS_NAME_LEN];	// The file name, NUL padded
+	uint32_t						offset;			// The file data offset from the image start
+	uint32_t						size;			// The file size
+} MMAPFS_DIRENTRY;
+
+static const MMAPFS_HEADER *	FsMmapHead;
+static const MMAPFS_DIRENTRY *	FsMmapDir;
+
+typedef struct MmapFileList {
+	gfileList				fl;
+	uint16_t				idx;
+} MmapFileList;
+
+
+static bool_t MmapExists(const char *fname);
+static long int	MmapFilesize(const char *fname);
+static bool_t MmapOpen(GFILE *f, const char *fname);
+static void MmapClose(GFILE *f);
+static int MmapRead(GFILE *f, void *buf, int size);
+static bool_t MmapSetpos(GFILE *f, long int pos);
+static long int MmapGetsize(GFILE *f);
+static bool_t MmapEof(GFILE *f);
+#if GFILE_NEED_FILELISTS
+	static gfileList *MmapFlOpen(const char *path, bool_t dirs);
+	static const char *MmapFlRead(gfileList *pfl);
+	static void MmapFlClose(gfileList *pfl);
+#endif
+
+const GFILEVMT FsMmapVMT = {
+	GFSFLG_CASESENSITIVE|GFSFLG_SEEKABLE|GFSFLG_FAST,	// flags
+	'A',												// prefix
+	0, MmapExists, MmapFilesize, 0,
+	MmapOpen, MmapClose, MmapRead, 0,
+	MmapSetpos, MmapGetsize, MmapEof,
+	0, 0, 0,
+	#if GFILE_NEED_FILELISTS
+		MmapFlOpen, MmapFlRead, MmapFlClose
+	#endif
+};
+
+void _gfileMmapInit(void)
+{
+	const esp_partition_t *		part;
+	const MMAPFS_HEADER *		p;
+	spi_flash_mmap_handle_t		handle;
+
+	part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, GFILE_MMAPFS_LABEL);
+	if (!part)
+		return;
+
+	// The mapping is kept for the lifetime of the application
+	if (esp_partition_mmap(part, 0, part->size, SPI_FLASH_MMAP_DATA, (const void **)&p, &handle) != ESP_OK)
+		return;
+
+	// An erased or foreign partition simply appears empty
+	if (p->magic != MMAPFS_MAGIC || p->ver > MMAPFS_VER_MAX || p->size > part->size
+			|| sizeof(MMAPFS_HEADER) + p->count * sizeof(MMAPFS_DIRENTRY) > p->size) {
+		spi_flash_munmap(handle);
+		return;
+	}
+
+	FsMmapDir = (const MMAPFS_DIRENTRY *)(p+1);
+	FsMmapHead = p;
+}
+
+static const MMAPFS_DIRENTRY *MmapFindFile(const char *fname)
+{
+	const MMAPFS_DIRENTRY *p;
+
+	if (!FsMmapHead)
+		return 0;
+
+	for(p = FsMmapDir; p < &FsMmapDir[FsMmapHead->count]; p++) {
+		if (!strncmp(p->name, fname, MMAPFS_NAME_LEN) && p->offset + p->size <= FsMmapHead->size)
+			return p;
+	}
+	return 0;
+}
+
+const void *gfileMmapPointer(const char *fname, long int *psize)
+{
+	const MMAPFS_DIRENTRY *p;
+
+	if (!(p = MmapFindFile(fname))) return 0;
+	if (psize)
+		*psize = p->size;
+	return (const char *)FsMmapHead + p->offset;
+}
+
+static bool_t MmapExists(const char *fname)
+{
+	return MmapFindFile(fname) != 0;
+}
+
+static long int	MmapFilesize(const char *fname)
+{
+	const MMAPFS_DIRENTRY *p;
+
+	if (!(p = MmapFindFile(fname))) return -1;
+	return p->size;
+}
+
+static bool_t MmapOpen(GFILE *f, const char *fname)
+{
+	const MMAPFS_DIRENTRY *p;
+
+	if (!(p = MmapFindFile(fname))) return FALSE;
+	f->obj = (void *)p;
+	return TRUE;
+}
+
+static void MmapClose(GFILE *f)
+{
+	(void)f;
+}
+
+static int MmapRead(GFILE *f, void *buf, int size)
+{
+	const MMAPFS_DIRENTRY *p;
+
+	p = (const MMAPFS_DIRENTRY *)f->obj;
+	if ((long int)p->size - f->pos < size)
+		size = p->size - f->pos;
+	if (size <= 0)	return 0;
+	memcpy(buf, (const char *)FsMmapHead + p->offset + f->pos, size);
+	return size;
+}
+
+static bool_t MmapSetpos(GFILE *f, long int pos)
+{
+	return pos <= (long int)((const MMAPFS_DIRENTRY *)f->obj)->size;
+}
+
+static long int MmapGetsize(GFILE *f)
+{
+	return ((const MMAPFS_DIRENTRY *)f->obj)->size;
+}
+
+static bool_t MmapEof(GFILE *f)
+{
+	return f->pos >= (long int)((const MMAPFS_DIRENTRY *)f->obj)->size;
+}
+
+#if GFILE_NEED_FILELISTS
+	static gfileList *MmapFlOpen(const char *path, bool_t dirs) {
+		MmapFileList *	p;
+		(void)			path;
+
+		// We don't support directories or path searching
+		if (dirs)
+			return 0;
+
+		// Allocate the list buffer
+		if (!(p = gfxAlloc(sizeof(MmapFileList))))
+			return 0;
+
+		// Initialize it and return it.
+		p->idx = 0;
+		return &p->fl;
+	}
+
+	static const char *MmapFlRead(gfileList *pfl) {
+		#define mfl		((MmapFileList *)pfl)
+
+		if (!FsMmapHead || mfl->idx >= FsMmapHead->count)
+			return 0;
+
+		// The packer guarantees the names are NUL terminated
+		return FsMmapDir[mfl->idx++].name;
+		#undef mfl
+	}
+
+	static void MmapFlClose(gfileList *pfl) {
+		gfxFree(pfl);
+	}
+#endif
+
+#endif //GFX_USE_GFILE && GFILE_NEED_MMAPFS
@@ -9,6 +9,7 @@
 #include "gfile_fs_native.c"
 #include "gfile_fs_ram.c"
 #include "gfile_fs_rom.c"
+#include "gfile_fs_mmap.c"
 #include "gfile_fs_fatfs.c"
 #include "gfile_fs_petitfs.c"
 #include "gfile_fs_mem.c"
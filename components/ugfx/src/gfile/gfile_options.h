@@ -115,6 +115,20 @@
 	#ifndef GFILE_NEED_RAMFS
 		#define GFILE_NEED_RAMFS		FALSE
 	#endif
+	/**
+	 * @brief   Include the memory-mapped flash partition file system
+	 * @details	Defaults to FALSE
+	 * @pre		This is only relevant on the ESP-IDF platform.
+	 * @note	If GFILE_ALLOW_DEVICESPECIFIC is on then you can ensure that you are
+	 * 			opening a file on the mapped file system by prefixing
+	 * 			its name with "A|" (the letter 'A', followed by a vertical bar).
+	 * @note	The partition named by GFILE_MMAPFS_LABEL is mapped once at init and must
+	 * 			hold an image built by the tools/pack_assets.py utility.
+	 * @note	Use @p gfileMmapPointer() to get the file data in place without copying.
+	 */
+	#ifndef GFILE_NEED_MMAPFS
+		#define GFILE_NEED_MMAPFS		FALSE
+	#endif
 	/**
 	 * @brief   Include the FAT file system driver based on the FATFS library
 	 * @details	Defaults to FALSE
@@ -216,6 +230,12 @@
 	#ifndef GFILE_MAX_GFILES
 		#define GFILE_MAX_GFILES		3
 	#endif
+	/**
+	 * @brief   The label of the flash partition mapped by the GFILE_NEED_MMAPFS file system
+	 */
+	#ifndef GFILE_MMAPFS_LABEL
+		#define GFILE_MMAPFS_LABEL		"assets"
+	#endif
 	/**
 	 * @brief   TUse an external FATFS library instead of the uGFX inbuilt one
 	 * @note	This is applicable when GFILE_NEED_FATFS is specified. It allows
@@ -150,6 +150,21 @@
 	 */
 	void *gfxAlloc(size_t sz);
 
+	/**
+	 * @brief	Allocate memory with the given capabilities
+	 * @return	A pointer to the memory allocated or NULL if there is no more memory available
+	 *
+	 * @param[in] sz	The size in bytes of the area to allocate
+	 * @param[in] caps	GFX_ALLOC_DMA for 32 bit aligned memory that DMA can read directly, or
+	 * 					GFX_ALLOC_SPIRAM to prefer external RAM for large buffers never handed to DMA
+	 *
+	 * @note	Operating systems without capability aware heaps treat this as gfxAlloc().
+	 * @note	The memory is released with gfxFree().
+	 *
+	 * @api
+	 */
+	void *gfxAllocCaps(size_t sz, uint32_t caps);
+
 	/**
 	 * @brief	Re-allocate memory
 	 * @return	A pointer to the new memory area or NULL if there is no more memory available
@@ -492,5 +507,13 @@
 	#error "Your operating system is not supported yet"
 #endif
 
+/* Ports without a capability aware heap ignore the hints */
+#if !defined(__DOXYGEN__) && !defined(GFX_ALLOC_DMA)
+	#define GFX_ALLOC_DEFAULT			0x00
+	#define GFX_ALLOC_DMA				0x01
+	#define GFX_ALLOC_SPIRAM			0x02
+	#define gfxAllocCaps(sz, caps)		gfxAlloc(sz)
+#endif
+
 #endif /* _GOS_H */
 /** @} */
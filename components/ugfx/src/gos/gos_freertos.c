@@ -10,6 +10,8 @@
 
 #if GFX_USE_OS_FREERTOS
 
+#include "esp_heap_caps.h"
+
 #if INCLUDE_vTaskDelay != 1
 	#error "GOS: INCLUDE_vTaskDelay must be defined in FreeRTOSConfig.h"
 #endif
@@ -66,6 +68,24 @@ void _gosDeinit(void)
 	#endif
 }
 
+void *gfxAllocCaps(size_t sz, uint32_t caps)
+{
+	void *p = 0;
+
+	// DMA wins over external RAM, the SPI DMA can't reach it
+	if (caps & GFX_ALLOC_DMA)
+		return heap_caps_malloc(sz, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL | MALLOC_CAP_32BIT);
+
+	if (caps & GFX_ALLOC_SPIRAM)
+		p = heap_caps_malloc(sz, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+
+	// No external RAM fitted or it is full
+	if (!p)
+		p = gfxAlloc(sz);
+
+	return p;
+}
+
 void* gfxRealloc(void *ptr, size_t oldsz, size_t newsz)
 {
 	void *np;
@@ -80,6 +80,11 @@ extern "C" {
 #define gfxExit()					{while(1);}
 #define gfxAlloc(sz)				pvPortMalloc(sz)
 #define gfxFree(ptr)				vPortFree(ptr)
+
+#define GFX_ALLOC_DEFAULT			0x00
+#define GFX_ALLOC_DMA				0x01		// Internal, 32 bit aligned, usable by SPI DMA
+#define GFX_ALLOC_SPIRAM			0x02		// External RAM if fitted, never for DMA buffers
+void *gfxAllocCaps(size_t sz, uint32_t caps);
 #define gfxYield()					taskYIELD()
 #define gfxSystemTicks()			xTaskGetTickCount()
 #define gfxMillisecondsToTicks(ms)	((systemticks_t)((ms) / portTICK_PERIOD_MS))
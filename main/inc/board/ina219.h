@@ -8,14 +8,72 @@
 #ifndef INC_BOARD_INA219_H_
 #define INC_BOARD_INA219_H_
 
-extern void ina219_set_calibration_32v_2a(void);
-extern void ina219_set_calibration_32v_1a(void);
-extern void ina219_set_calibration_16v_400ma(void);
-
-extern float ina219_get_shunt_voltage_mv(void);
-extern float ina219_get_bus_voltage_mv(void);
-extern float ina219_get_current_ma(void);
-extern float ina219_get_power_mw(void);
+#include "esp_err.h"
+
+#define INA219_ADDR_MIN 0x40    // A0 + A1 = GND
+#define INA219_ADDR_MAX 0x4F    // A0 + A1 = SCL
+
+#define INA219_NUM_MAX  4
+
+typedef struct ina219 ina219_t;
+
+typedef enum {
+    INA219_RANGE_IDX_16V_400MA = 0x00,
+    INA219_RANGE_IDX_32V_1A    = 0x01,
+    INA219_RANGE_IDX_32V_2A    = 0x02,
+
+    INA219_RANGE_IDX_MAX
+} ina219_range_t;
+
+typedef enum {
+    INA219_ADC_IDX_9BIT       = 0x0,    // 84us
+    INA219_ADC_IDX_10BIT      = 0x1,    // 148us
+    INA219_ADC_IDX_11BIT      = 0x2,    // 276us
+    INA219_ADC_IDX_12BIT      = 0x3,    // 532us
+    INA219_ADC_IDX_12BIT_2S   = 0x9,    // 1.06ms
+    INA219_ADC_IDX_12BIT_4S   = 0xA,    // 2.13ms
+    INA219_ADC_IDX_12BIT_8S   = 0xB,    // 4.26ms
+    INA219_ADC_IDX_12BIT_16S  = 0xC,    // 8.51ms
+    INA219_ADC_IDX_12BIT_32S  = 0xD,    // 17.02ms
+    INA219_ADC_IDX_12BIT_64S  = 0xE,    // 34.05ms
+    INA219_ADC_IDX_12BIT_128S = 0xF     // 68.10ms
+} ina219_adc_t;
+
+typedef enum {
+    INA219_MODE_IDX_CONTINUOUS = 0x00,
+    INA219_MODE_IDX_TRIGGERED  = 0x01
+} ina219_mode_t;
+
+extern void ina219_set_calibration_32v_2a(ina219_t *dev);
+extern void ina219_set_calibration_32v_1a(ina219_t *dev);
+extern void ina219_set_calibration_16v_400ma(ina219_t *dev);
+
+extern void ina219_set_auto_range(ina219_t *dev);
+extern ina219_range_t ina219_get_range(ina219_t *dev);
+
+extern void ina219_set_adc(ina219_t *dev, ina219_adc_t adc, ina219_mode_t mode);
+extern ina219_adc_t ina219_get_adc(ina219_t *dev);
+extern ina219_mode_t ina219_get_mode(ina219_t *dev);
+extern uint32_t ina219_get_conversion_time(ina219_t *dev);
+
+extern uint8_t ina219_get_addr(ina219_t *dev);
+
+extern int32_t ina219_get_shunt_voltage_uv(ina219_t *dev);
+extern int32_t ina219_get_bus_voltage_uv(ina219_t *dev);
+extern int32_t ina219_get_current_ua(ina219_t *dev);
+extern int32_t ina219_get_power_uw(ina219_t *dev);
+
+extern float ina219_get_shunt_voltage_mv(ina219_t *dev);
+extern float ina219_get_bus_voltage_mv(ina219_t *dev);
+extern float ina219_get_current_ma(ina219_t *dev);
+extern float ina219_get_power_mw(ina219_t *dev);
+
+extern esp_err_t ina219_read_current_ua(ina219_t *dev, int32_t *current);
+extern esp_err_t ina219_read_current(ina219_t *dev, float *current);
+extern esp_err_t ina219_update(ina219_t *dev);
+
+extern uint8_t ina219_get_count(void);
+extern ina219_t *ina219_get(uint8_t idx);
 
 extern void ina219_init(void);
 
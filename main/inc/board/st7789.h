@@ -15,6 +15,11 @@
 #define ST7789_SCREEN_WIDTH  135
 #define ST7789_SCREEN_HEIGHT 240
 
+#ifdef CONFIG_LCD_RENDER_MODE_STRIP
+    #define ST7789_STRIP_LINES CONFIG_LCD_STRIP_LINES
+    #define ST7789_STRIP_SIZE  (ST7789_SCREEN_HEIGHT * ST7789_STRIP_LINES)
+#endif
+
 extern void st7789_init_board(void);
 
 extern void st7789_set_backlight(uint8_t val);
@@ -23,7 +28,9 @@ extern void st7789_setpin_reset(uint8_t val);
 
 extern void st7789_write_cmd(uint8_t cmd);
 extern void st7789_write_data(uint8_t data);
+extern void st7789_write_cmd_data(uint8_t cmd, const uint8_t *data, uint32_t n);
 extern void st7789_write_buff(uint8_t *buff, uint32_t n);
+extern void st7789_write_strip(uint8_t *buff, uint32_t n);
 extern void st7789_refresh_gram(uint8_t *gram);
 
 #endif /* INC_BOARD_ST7789_H_ */
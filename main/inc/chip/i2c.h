@@ -8,11 +8,56 @@
 #ifndef INC_CHIP_I2C_H_
 #define INC_CHIP_I2C_H_
 
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
 #include "driver/i2c.h"
 
 #define I2C_HOST_TAG "i2c-0"
 #define I2C_HOST_NUM I2C_NUM_0
 
+// one register access, data is in bus order (MSB first)
+typedef struct {
+    uint8_t reg;
+    uint8_t len;
+    bool write;
+    uint8_t *data;
+} i2c_host_op_t;
+
+typedef struct i2c_host_req i2c_host_req_t;
+
+/*
+ * Called from the bus task when a request is done. It may return a follow-up
+ * request, which goes on the bus right away, ahead of anything queued, or NULL
+ * to end the chain. Callbacks must not wait on the bus themselves.
+ */
+typedef i2c_host_req_t *(*i2c_host_cb_t)(esp_err_t ret, void *arg);
+
+/*
+ * A request is owned by the submitter and must stay valid until it completes.
+ * Its ops are built into a command link on first use and that link is reused
+ * on every later submission, so the ops and their data buffers are fixed.
+ */
+struct i2c_host_req {
+    uint8_t addr;
+    uint8_t num;
+    i2c_host_op_t *ops;
+    uint32_t timeout;       // in ms
+
+    i2c_host_cb_t cb;       // NULL if there is nothing to chain
+    void *arg;
+
+    esp_err_t ret;          // of the last request in the chain
+    bool busy;              // waited on by i2c_host_exec()
+    SemaphoreHandle_t done;
+    i2c_cmd_handle_t cmd;
+};
+
+extern esp_err_t i2c_host_submit(i2c_host_req_t *req);
+extern esp_err_t i2c_host_exec(i2c_host_req_t *req);
+extern void i2c_host_release(i2c_host_req_t *req);
+
 extern void i2c_host_init(void);
 
 #endif /* INC_CHIP_I2C_H_ */
@@ -33,6 +33,7 @@ typedef struct {
 extern xQueueHandle fan_evt_queue;
 
 extern uint16_t fan_get_rpm(void);
+extern uint16_t fan_get_tach_rpm(void);
 
 extern void fan_set_mode(fan_mode_t idx);
 extern fan_mode_t fan_get_mode(void);
@@ -13,9 +13,21 @@ typedef enum {
     GUI_MODE_IDX_OFF = 0xFF
 } gui_mode_t;
 
+typedef enum {
+    GUI_PAGE_IDX_INFO   = 0x00,
+    GUI_PAGE_IDX_GRAPH  = 0x01,
+    GUI_PAGE_IDX_ENERGY = 0x02,
+    GUI_PAGE_IDX_STATS  = 0x03,
+
+    GUI_PAGE_IDX_MAX
+} gui_page_t;
+
 extern void gui_set_mode(gui_mode_t idx);
 extern gui_mode_t gui_get_mode(void);
 
+extern void gui_set_page(gui_page_t idx);
+extern gui_page_t gui_get_page(void);
+
 extern void gui_init(void);
 
 #endif /* INC_USER_GUI_H_ */
@@ -0,0 +1,55 @@
+/*
+ * meter.h
+ *
+ *  Created on: 2020-06-02 20:15
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#ifndef INC_USER_METER_H_
+#define INC_USER_METER_H_
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#include "board/ina219.h"
+
+#define METER_US_PER_HOUR 3600000000LL
+
+#define METER_CHAN_MAX    INA219_NUM_MAX
+#define METER_CAPTURE_MAX 2048
+
+typedef struct {
+    int64_t charge;     // in mA*us
+    int64_t energy;     // in mW*us
+} meter_total_t;
+
+typedef struct {
+    float voltage;      // bus voltage in mV
+    float current;      // in mA
+    float power;        // in mW
+    int64_t time;       // esp_timer time of the reading in us, 0 before the first one
+    meter_total_t session;
+    meter_total_t lifetime;
+} meter_data_t;
+
+typedef struct {
+    uint32_t time;      // in us since the start of the capture
+    float current;      // in mA
+} meter_sample_t;
+
+extern void meter_get_data(uint8_t idx, meter_data_t *data);
+extern uint8_t meter_get_count(void);
+extern uint8_t meter_get_addr(uint8_t idx);
+
+extern void meter_set_adc(ina219_adc_t adc, ina219_mode_t mode);
+
+extern esp_err_t meter_capture_start(uint8_t idx, uint16_t count);
+extern const meter_sample_t *meter_capture_get(uint16_t *count);
+
+extern void meter_reset_session(void);
+extern void meter_env_save(void);
+
+extern void meter_init(void);
+
+#endif /* INC_USER_METER_H_ */
@@ -0,0 +1,22 @@
+/*
+ * ripple.h
+ *
+ *  Created on: 2020-06-12 19:05
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#ifndef INC_USER_RIPPLE_H_
+#define INC_USER_RIPPLE_H_
+
+#include <stdint.h>
+
+#include "user/meter.h"
+
+extern uint32_t ripple_estimate(const meter_sample_t *samples, uint16_t count);
+
+extern void ripple_update(const meter_sample_t *samples, uint16_t count);
+extern void ripple_clear(void);
+
+extern uint16_t ripple_get_rpm(void);
+
+#endif /* INC_USER_RIPPLE_H_ */
@@ -0,0 +1,45 @@
+/*
+ * stats.h
+ *
+ *  Created on: 2020-06-09 21:40
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#ifndef INC_USER_STATS_H_
+#define INC_USER_STATS_H_
+
+#include <stdint.h>
+
+typedef enum {
+    STATS_SRC_IDX_VOLTAGE = 0x00,   // in mV
+    STATS_SRC_IDX_CURRENT = 0x01,   // in mA
+    STATS_SRC_IDX_POWER   = 0x02,   // in mW
+    STATS_SRC_IDX_RPM     = 0x03,
+
+    STATS_SRC_IDX_MAX
+} stats_src_t;
+
+typedef enum {
+    STATS_WIN_IDX_1S   = 0x00,
+    STATS_WIN_IDX_10S  = 0x01,
+    STATS_WIN_IDX_1MIN = 0x02,
+
+    STATS_WIN_IDX_MAX
+} stats_win_t;
+
+typedef struct {
+    float min;
+    float max;
+    float mean;
+    float std;          // population standard deviation
+    uint16_t count;     // samples in the window, less than full until it has filled up
+} stats_result_t;
+
+extern void stats_get(stats_src_t src, stats_win_t win, stats_result_t *res);
+
+extern void stats_set_sel(stats_src_t src, stats_win_t win);
+extern void stats_get_sel(stats_src_t *src, stats_win_t *win);
+
+extern void stats_init(void);
+
+#endif /* INC_USER_STATS_H_ */
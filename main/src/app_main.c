@@ -21,6 +21,8 @@
 #include "user/fan.h"
 #include "user/gui.h"
 #include "user/led.h"
+#include "user/meter.h"
+#include "user/stats.h"
 #include "user/ble_app.h"
 
 static void core_init(void)
@@ -54,6 +56,16 @@ static void board_init(void)
 
 static void user_init(void)
 {
+#ifdef CONFIG_ENABLE_POWER_MONITOR
+    meter_init();
+
+    stats_init();
+#endif
+
+#ifdef CONFIG_ENABLE_GUI
+    gui_init();
+#endif
+
 #ifdef CONFIG_ENABLE_ENCODER
     ec_init();
 #endif
@@ -68,10 +80,6 @@ static void user_init(void)
 
     fan_init();
 
-#ifdef CONFIG_ENABLE_GUI
-    gui_init();
-#endif
-
 #ifdef CONFIG_ENABLE_LED
     led_init();
 #endif
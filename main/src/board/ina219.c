@@ -5,15 +5,17 @@
  *      Author: Jack Chen <redchenjs@live.com>
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "esp_log.h"
 
 #include "chip/i2c.h"
 
+#include "board/ina219.h"
+
 #define TAG "ina219"
 
-#define INA219_ADDR               0x40    // A0 + A1 = GND
 
 #define INA219_REG_CONFIG         0x00
 #define INA219_REG_SHUNT_VOLTAGE  0x01
@@ -22,6 +24,17 @@
 #define INA219_REG_CURRENT        0x04
 #define INA219_REG_CALIBRATION    0x05
 
+#define INA219_BUS_CNVR           0x0002  // conversion ready
+#define INA219_BUS_OVF            0x0001  // math overflow
+
+#define INA219_BUS_LSB            4000    // in uV
+#define INA219_SHUNT_LSB          10      // in uV
+#define INA219_PWR_LSB_MUL        20      // power LSB = 20 * current LSB
+
+#define INA219_RANGE_HOLD         4       // readings below the lower range before switching down
+
+#define INA219_TIMEOUT            20      // in ms
+
 typedef union {
     struct {
         uint8_t mode:     3;
@@ -47,20 +60,6 @@ enum pga_settings {
     PGA_GAIN_8_320MV = 0x3
 };
 
-enum adc_settings {
-    ADC_RES_9BIT       = 0x0,
-    ADC_RES_10BIT      = 0x1,
-    ADC_RES_11BIT      = 0x2,
-    ADC_RES_12BIT      = 0x3,
-    ADC_RES_12BIT_2S   = 0x9,
-    ADC_RES_12BIT_4S   = 0xA,
-    ADC_RES_12BIT_8S   = 0xB,
-    ADC_RES_12BIT_16S  = 0xC,
-    ADC_RES_12BIT_32S  = 0xD,
-    ADC_RES_12BIT_64S  = 0xE,
-    ADC_RES_12BIT_128S = 0xF
-};
-
 enum mode_settings {
     MODE_POWER_DOWN               = 0x0,
     MODE_SHUNT_VOLTAGE_TRIGGERED  = 0x1,
@@ -72,174 +71,577 @@ enum mode_settings {
     MODE_SHUNT_AND_BUS_CONTINUOUS = 0x7
 };
 
-static uint16_t ina219_cal_val = 0;
-static uint16_t ina219_cur_div = 1;
-static float    ina219_pwr_mul = 0.0;
+typedef struct {
+    uint16_t cal_val;
+    uint16_t cur_lsb;   // in uA
+    uint8_t  brng;
+    uint8_t  pg;
+    uint16_t cur_up;    // in mA, switch to the next range above this
+    uint16_t cur_down;  // in mA, switch back into this range below this
+    uint16_t bus_up;    // in mV, switch to the next range above this
+    uint16_t bus_down;  // in mV, switch back into this range below this
+} ina219_range_cfg_t;
+
+static const ina219_range_cfg_t ina219_range_cfg[INA219_RANGE_IDX_MAX] = {
+    [INA219_RANGE_IDX_16V_400MA] = {
+        .cal_val  = 8192,       // 400mA max
+        .cur_lsb  = 50,         // 1mW per power bit
+        .brng     = BRNG_16V_FSR,
+        .pg       = PGA_GAIN_1_40MV,
+        .cur_up   = 360,
+        .cur_down = 300,
+        .bus_up   = 15000,
+        .bus_down = 14000
+    },
+    [INA219_RANGE_IDX_32V_1A] = {
+        .cal_val  = 10240,      // 1.3A max
+        .cur_lsb  = 40,         // 800uW per power bit
+        .brng     = BRNG_32V_FSR,
+        .pg       = PGA_GAIN_8_320MV,
+        .cur_up   = 1200,
+        .cur_down = 1000,
+        .bus_up   = UINT16_MAX,
+        .bus_down = UINT16_MAX
+    },
+    [INA219_RANGE_IDX_32V_2A] = {
+        .cal_val  = 4096,       // 3.2A max
+        .cur_lsb  = 100,        // 2mW per power bit
+        .brng     = BRNG_32V_FSR,
+        .pg       = PGA_GAIN_8_320MV,
+        .cur_up   = UINT16_MAX,
+        .cur_down = UINT16_MAX,
+        .bus_up   = UINT16_MAX,
+        .bus_down = UINT16_MAX
+    }
+};
+
+// in us, indexed by the BADC/SADC setting
+static const uint32_t ina219_adc_time[16] = {
+    84, 148, 276, 532, 84, 148, 276, 532,
+    532, 1060, 2130, 4260, 8510, 17020, 34050, 68100
+};
+
+typedef enum {
+    INA219_REQ_IDX_POLL    = 0x00,  // bus voltage with CNVR and OVF
+    INA219_REQ_IDX_FETCH   = 0x01,  // current + power, clears CNVR
+    INA219_REQ_IDX_CURRENT = 0x02,
+    INA219_REQ_IDX_SHUNT   = 0x03,
+    INA219_REQ_IDX_VERIFY  = 0x04,  // calibration read back
+    INA219_REQ_IDX_SETUP   = 0x05,  // calibration + config
+    INA219_REQ_IDX_TRIGGER = 0x06,  // config
+
+    INA219_REQ_IDX_MAX
+} ina219_req_idx_t;
+
+typedef enum {
+    INA219_OP_IDX_BUS     = 0x00,
+    INA219_OP_IDX_CUR     = 0x01,
+    INA219_OP_IDX_PWR     = 0x02,
+    INA219_OP_IDX_SHUNT   = 0x03,
+    INA219_OP_IDX_CAL_R   = 0x04,
+    INA219_OP_IDX_CAL_W   = 0x05,
+    INA219_OP_IDX_CONF    = 0x06,
+
+    INA219_OP_IDX_MAX
+} ina219_op_idx_t;
+
+struct ina219 {
+    uint8_t addr;
+
+    uint16_t cal_val;
+    uint16_t cur_lsb;
+
+    ina219_conf_t conf;
+
+    ina219_range_t range;
+    bool auto_range;
+    uint8_t range_cnt;
+
+    ina219_adc_t  adc;
+    ina219_mode_t mode;
 
-static ina219_conf_t ina219_conf = {0};
+    bool cal_err;
+    bool discard;
 
-static void ina219_reg_write(uint8_t reg, const uint8_t *buff)
+    // results of the last good conversion, scaled with the range it was taken in
+    int32_t bus_uv;
+    int32_t cur_ua;
+    int32_t pwr_uw;
+
+#ifdef CONFIG_ENABLE_POWER_MONITOR
+    // register buffers in bus order, the requests are built once around them
+    uint8_t buff[INA219_OP_IDX_MAX][2];
+    i2c_host_op_t op[INA219_OP_IDX_MAX];
+    i2c_host_op_t op_fetch[2];
+    i2c_host_op_t op_setup[2];
+    i2c_host_req_t req[INA219_REQ_IDX_MAX];
+#endif
+};
+
+static ina219_t ina219_dev[INA219_NUM_MAX] = {0};
+static uint8_t ina219_num = 0;
+
+#ifdef CONFIG_ENABLE_POWER_MONITOR
+static const uint8_t ina219_op_reg[INA219_OP_IDX_MAX] = {
+    [INA219_OP_IDX_BUS]   = INA219_REG_BUS_VOLTAGE,
+    [INA219_OP_IDX_CUR]   = INA219_REG_CURRENT,
+    [INA219_OP_IDX_PWR]   = INA219_REG_POWER,
+    [INA219_OP_IDX_SHUNT] = INA219_REG_SHUNT_VOLTAGE,
+    [INA219_OP_IDX_CAL_R] = INA219_REG_CALIBRATION,
+    [INA219_OP_IDX_CAL_W] = INA219_REG_CALIBRATION,
+    [INA219_OP_IDX_CONF]  = INA219_REG_CONFIG,
+};
+
+static inline int16_t ina219_get_be16(const uint8_t *buff)
 {
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+    return buff[0] << 8 | buff[1];
+}
 
-    i2c_master_start(cmd);
+static inline void ina219_put_be16(uint8_t *buff, uint16_t val)
+{
+    buff[0] = val >> 8;
+    buff[1] = val & 0xff;
+}
 
-    i2c_master_write_byte(cmd, INA219_ADDR << 1 | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(cmd, reg, true);
-    i2c_master_write_byte(cmd, buff[1], true);
-    i2c_master_write_byte(cmd, buff[0], true);
+// current and power are only fetched once the poll has seen CNVR
+static i2c_host_req_t *ina219_poll_done(esp_err_t ret, void *arg)
+{
+    ina219_t *dev = arg;
 
-    i2c_master_stop(cmd);
+    if (ret != ESP_OK || !(ina219_get_be16(dev->buff[INA219_OP_IDX_BUS]) & INA219_BUS_CNVR)) {
+        return NULL;
+    }
 
-    i2c_master_cmd_begin(I2C_HOST_NUM, cmd, portMAX_DELAY);
+    return &dev->req[INA219_REQ_IDX_FETCH];
+}
 
-    i2c_cmd_link_delete(cmd);
+// in triggered mode every conversion is started by a config write
+static i2c_host_req_t *ina219_fetch_done(esp_err_t ret, void *arg)
+{
+    ina219_t *dev = arg;
+
+    if (ret != ESP_OK || dev->mode != INA219_MODE_IDX_TRIGGERED) {
+        return NULL;
+    }
+
+    return &dev->req[INA219_REQ_IDX_TRIGGER];
 }
 
-#ifdef CONFIG_ENABLE_POWER_MONITOR
-static void ina219_reg_read(uint8_t reg, uint8_t *buff)
+static void ina219_req_setup(ina219_t *dev, ina219_req_idx_t idx, i2c_host_op_t *ops, uint8_t num,
+                             i2c_host_cb_t cb)
 {
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+    dev->req[idx].addr    = dev->addr;
+    dev->req[idx].num     = num;
+    dev->req[idx].ops     = ops;
+    dev->req[idx].timeout = INA219_TIMEOUT;
+    dev->req[idx].cb      = cb;
+    dev->req[idx].arg     = dev;
+}
 
-    i2c_master_start(cmd);
+static void ina219_dev_setup(ina219_t *dev, uint8_t addr)
+{
+    dev->addr = addr;
+
+    dev->cur_lsb = 1;
+    dev->range = INA219_RANGE_IDX_32V_2A;
+    dev->adc   = INA219_ADC_IDX_12BIT_128S;
+    dev->mode  = INA219_MODE_IDX_CONTINUOUS;
+
+    for (int i = 0; i < INA219_OP_IDX_MAX; i++) {
+        dev->op[i].reg   = ina219_op_reg[i];
+        dev->op[i].len   = 2;
+        dev->op[i].write = (i == INA219_OP_IDX_CAL_W || i == INA219_OP_IDX_CONF);
+        dev->op[i].data  = dev->buff[i];
+    }
+
+    dev->op_fetch[0] = dev->op[INA219_OP_IDX_CUR];
+    dev->op_fetch[1] = dev->op[INA219_OP_IDX_PWR];      // clears CNVR, so it goes last
+    dev->op_setup[0] = dev->op[INA219_OP_IDX_CAL_W];
+    dev->op_setup[1] = dev->op[INA219_OP_IDX_CONF];
+
+    ina219_req_setup(dev, INA219_REQ_IDX_POLL,    &dev->op[INA219_OP_IDX_BUS],   1, ina219_poll_done);
+    ina219_req_setup(dev, INA219_REQ_IDX_FETCH,   dev->op_fetch,                 2, ina219_fetch_done);
+    ina219_req_setup(dev, INA219_REQ_IDX_CURRENT, &dev->op[INA219_OP_IDX_CUR],   1, NULL);
+    ina219_req_setup(dev, INA219_REQ_IDX_SHUNT,   &dev->op[INA219_OP_IDX_SHUNT], 1, NULL);
+    ina219_req_setup(dev, INA219_REQ_IDX_VERIFY,  &dev->op[INA219_OP_IDX_CAL_R], 1, NULL);
+    ina219_req_setup(dev, INA219_REQ_IDX_SETUP,   dev->op_setup,                 2, NULL);
+    ina219_req_setup(dev, INA219_REQ_IDX_TRIGGER, &dev->op[INA219_OP_IDX_CONF],  1, NULL);
+}
 
-    i2c_master_write_byte(cmd, INA219_ADDR << 1 | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(cmd, reg, true);
+static esp_err_t ina219_apply_calibration(ina219_t *dev)
+{
+    ina219_put_be16(dev->buff[INA219_OP_IDX_CAL_W], dev->cal_val);
+    ina219_put_be16(dev->buff[INA219_OP_IDX_CONF], dev->conf.val);
 
-    i2c_master_start(cmd);
+    return i2c_host_exec(&dev->req[INA219_REQ_IDX_SETUP]);
+}
 
-    i2c_master_write_byte(cmd, INA219_ADDR << 1 | I2C_MASTER_READ, true);
-    i2c_master_read_byte(cmd, &buff[1], I2C_MASTER_ACK);
-    i2c_master_read_byte(cmd, &buff[0], I2C_MASTER_NACK);
+static esp_err_t ina219_verify_calibration(ina219_t *dev)
+{
+    esp_err_t ret = i2c_host_exec(&dev->req[INA219_REQ_IDX_VERIFY]);
+    if (ret != ESP_OK) {
+        return ret;
+    }
 
-    i2c_master_stop(cmd);
+    // a brown-out resets the chip and clears the calibration register
+    if ((uint16_t)ina219_get_be16(dev->buff[INA219_OP_IDX_CAL_R]) != dev->cal_val) {
+        ESP_LOGW(TAG, "0x%02X: calibration lost, restoring", dev->addr);
 
-    i2c_master_cmd_begin(I2C_HOST_NUM, cmd, portMAX_DELAY);
+        return ina219_apply_calibration(dev);
+    }
 
-    i2c_cmd_link_delete(cmd);
+    return ESP_OK;
 }
-#endif
 
-static int16_t ina219_get_shunt_voltage_raw(void)
+// anything answering a config register read in the INA219 address block is taken for one
+static bool ina219_probe(uint8_t addr)
 {
-    int16_t value = 0;
+    // not on the stack, a request that timed out is still pending on the bus
+    static uint8_t buff[2] = {0};
+    static i2c_host_op_t op = { INA219_REG_CONFIG, 2, false, buff };
+    static i2c_host_req_t req = { .num = 1, .ops = &op, .timeout = INA219_TIMEOUT };
 
-#ifdef CONFIG_ENABLE_POWER_MONITOR
-    ina219_reg_read(INA219_REG_SHUNT_VOLTAGE, (uint8_t *)&value);
+    i2c_host_release(&req);
+    if (req.busy) {
+        return false;
+    }
+
+    req.addr = addr;
+
+    esp_err_t ret = i2c_host_exec(&req);
+
+    i2c_host_release(&req);
+
+    return ret == ESP_OK;
+}
 #endif
 
-    return value;
+static void ina219_set_timing(ina219_t *dev)
+{
+    dev->conf.badc = dev->adc;
+    dev->conf.sadc = dev->adc;
+    dev->conf.mode = (dev->mode == INA219_MODE_IDX_TRIGGERED) ? MODE_SHUNT_AND_BUS_TRIGGERED : MODE_SHUNT_AND_BUS_CONTINUOUS;
 }
 
-static int16_t ina219_get_bus_voltage_raw(void)
+static void ina219_set_range(ina219_t *dev, ina219_range_t idx)
 {
-    int16_t value = 0;
+    const ina219_range_cfg_t *cfg = &ina219_range_cfg[idx];
+
+    dev->range   = idx;
+    dev->cal_val = cfg->cal_val;
+    dev->cur_lsb = cfg->cur_lsb;
+
+    dev->conf.rst  = 0;
+    dev->conf.brng = cfg->brng;
+    dev->conf.pg   = cfg->pg;
+
+    ina219_set_timing(dev);
 
 #ifdef CONFIG_ENABLE_POWER_MONITOR
-    ina219_reg_read(INA219_REG_BUS_VOLTAGE, (uint8_t *)&value);
+    ina219_apply_calibration(dev);
+
+    // the conversion running across the switch mixes both settings
+    dev->discard = true;
+    dev->range_cnt = 0;
+#endif
+}
+
+#ifdef CONFIG_ENABLE_POWER_MONITOR
+// returns true if the range was changed
+static bool ina219_auto_range_step(ina219_t *dev, int16_t bus, int16_t cur)
+{
+    const ina219_range_cfg_t *cfg = &ina219_range_cfg[dev->range];
+    int32_t current = abs(cur * dev->cur_lsb);                // in uA
+    int32_t voltage = ((uint16_t)bus >> 3) * INA219_BUS_LSB;  // in uV
+
+    if (dev->range + 1 < INA219_RANGE_IDX_MAX &&
+        ((bus & INA219_BUS_OVF) || current > cfg->cur_up * 1000 || voltage > cfg->bus_up * 1000)) {
+        ina219_set_range(dev, dev->range + 1);
+
+        ESP_LOGI(TAG, "0x%02X: range up: %u", dev->addr, dev->range);
+
+        return true;
+    }
+
+    if (dev->range > 0) {
+        cfg = &ina219_range_cfg[dev->range - 1];
+
+        if (current < cfg->cur_down * 1000 && voltage < cfg->bus_down * 1000) {
+            if (++dev->range_cnt >= INA219_RANGE_HOLD) {
+                ina219_set_range(dev, dev->range - 1);
+
+                ESP_LOGI(TAG, "0x%02X: range down: %u", dev->addr, dev->range);
+
+                return true;
+            }
+        } else {
+            dev->range_cnt = 0;
+        }
+    }
+
+    return false;
+}
 #endif
 
-    return ((value >> 3) * 4);
+void ina219_set_calibration_32v_2a(ina219_t *dev)
+{
+    dev->auto_range = false;
+
+    ina219_set_range(dev, INA219_RANGE_IDX_32V_2A);
 }
 
-static int16_t ina219_get_current_raw(void)
+void ina219_set_calibration_32v_1a(ina219_t *dev)
 {
-    int16_t value = 0;
+    dev->auto_range = false;
+
+    ina219_set_range(dev, INA219_RANGE_IDX_32V_1A);
+}
+
+void ina219_set_calibration_16v_400ma(ina219_t *dev)
+{
+    dev->auto_range = false;
+
+    ina219_set_range(dev, INA219_RANGE_IDX_16V_400MA);
+}
+
+void ina219_set_auto_range(ina219_t *dev)
+{
+    dev->auto_range = true;
+
+    // start wide, nothing can saturate before the first reading
+    ina219_set_range(dev, INA219_RANGE_IDX_32V_2A);
+}
+
+ina219_range_t ina219_get_range(ina219_t *dev)
+{
+    return dev->range;
+}
+
+// only the config register is written, the calibration and the range hold count are kept
+void ina219_set_adc(ina219_t *dev, ina219_adc_t adc, ina219_mode_t mode)
+{
+    if ((adc & 0x0F) == dev->adc && mode == dev->mode) {
+        return;
+    }
+
+    dev->adc  = adc & 0x0F;
+    dev->mode = mode;
+
+    ina219_set_timing(dev);
 
 #ifdef CONFIG_ENABLE_POWER_MONITOR
-    ina219_reg_write(INA219_REG_CALIBRATION, (const uint8_t *)&ina219_cal_val);
-    ina219_reg_read(INA219_REG_CURRENT, (uint8_t *)&value);
+    ina219_put_be16(dev->buff[INA219_OP_IDX_CONF], dev->conf.val);
+
+    if (i2c_host_exec(&dev->req[INA219_REQ_IDX_TRIGGER]) != ESP_OK) {
+        dev->cal_err = true;
+    }
+
+    // the conversion running across the change mixes both settings
+    dev->discard = true;
 #endif
 
-    return value;
+    ESP_LOGD(TAG, "0x%02X: adc: 0x%X, mode: %u, conversion time: %u us",
+             dev->addr, dev->adc, dev->mode, ina219_get_conversion_time(dev));
 }
 
-static int16_t ina219_get_power_raw(void)
+ina219_adc_t ina219_get_adc(ina219_t *dev)
+{
+    return dev->adc;
+}
+
+ina219_mode_t ina219_get_mode(ina219_t *dev)
+{
+    return dev->mode;
+}
+
+uint32_t ina219_get_conversion_time(ina219_t *dev)
+{
+    // shunt and bus are converted one after the other
+    return 2 * ina219_adc_time[dev->adc];
+}
+
+uint8_t ina219_get_addr(ina219_t *dev)
+{
+    return dev->addr;
+}
+
+int32_t ina219_get_shunt_voltage_uv(ina219_t *dev)
 {
     int16_t value = 0;
 
 #ifdef CONFIG_ENABLE_POWER_MONITOR
-    ina219_reg_write(INA219_REG_CALIBRATION, (const uint8_t *)&ina219_cal_val);
-    ina219_reg_read(INA219_REG_POWER, (uint8_t *)&value);
+    if (i2c_host_exec(&dev->req[INA219_REQ_IDX_SHUNT]) == ESP_OK) {
+        value = ina219_get_be16(dev->buff[INA219_OP_IDX_SHUNT]);
+    }
 #endif
 
-    return value;
+    return value * INA219_SHUNT_LSB;
 }
 
-void ina219_set_calibration_32v_2a(void)
+int32_t ina219_get_bus_voltage_uv(ina219_t *dev)
 {
-    ina219_cal_val = 4096;      // 3.2A max
-    ina219_cur_div = 10;        // 100uA per bit
-    ina219_pwr_mul = 2.0;       // 1mW per bit
+    return dev->bus_uv;
+}
 
-    ina219_conf.rst  = 0;
-    ina219_conf.brng = BRNG_32V_FSR;
-    ina219_conf.pg   = PGA_GAIN_8_320MV;
-    ina219_conf.badc = ADC_RES_12BIT_128S;
-    ina219_conf.sadc = ADC_RES_12BIT_128S;
-    ina219_conf.mode = MODE_SHUNT_AND_BUS_CONTINUOUS;
+int32_t ina219_get_current_ua(ina219_t *dev)
+{
+    return dev->cur_ua;
+}
 
-    ina219_reg_write(INA219_REG_CALIBRATION, (const uint8_t *)&ina219_cal_val);
-    ina219_reg_write(INA219_REG_CONFIG, (const uint8_t *)&ina219_conf);
+int32_t ina219_get_power_uw(ina219_t *dev)
+{
+    return dev->pwr_uw;
 }
 
-void ina219_set_calibration_32v_1a(void)
+/*
+ * Every LSB is a whole number of micro-units, so the integer values are exact.
+ * They also stay below 2^24 once the trailing zeros are taken out, which makes
+ * them exact in a float and the division the only rounding step.
+ */
+float ina219_get_shunt_voltage_mv(ina219_t *dev)
 {
-    ina219_cal_val = 10240;     // 1.3A max
-    ina219_cur_div = 25;        // 40uA per bit
-    ina219_pwr_mul = 0.8;       // 800uW per bit
+    return ina219_get_shunt_voltage_uv(dev) / 1000.0f;
+}
 
-    ina219_conf.rst  = 0;
-    ina219_conf.brng = BRNG_32V_FSR;
-    ina219_conf.pg   = PGA_GAIN_8_320MV;
-    ina219_conf.badc = ADC_RES_12BIT_128S;
-    ina219_conf.sadc = ADC_RES_12BIT_128S;
-    ina219_conf.mode = MODE_SHUNT_AND_BUS_CONTINUOUS;
+float ina219_get_bus_voltage_mv(ina219_t *dev)
+{
+    return dev->bus_uv / 1000.0f;
+}
 
-    ina219_reg_write(INA219_REG_CALIBRATION, (const uint8_t *)&ina219_cal_val);
-    ina219_reg_write(INA219_REG_CONFIG, (const uint8_t *)&ina219_conf);
+float ina219_get_current_ma(ina219_t *dev)
+{
+    return dev->cur_ua / 1000.0f;
 }
 
-void ina219_set_calibration_16v_400ma(void)
+float ina219_get_power_mw(ina219_t *dev)
 {
-    ina219_cal_val = 8192;      // 400mA max
-    ina219_cur_div = 20;        // 50uA per bit
-    ina219_pwr_mul = 1.0;       // 1mW per bit
+    return dev->pwr_uw / 1000.0f;
+}
+
+esp_err_t ina219_read_current_ua(ina219_t *dev, int32_t *current)
+{
+#ifdef CONFIG_ENABLE_POWER_MONITOR
+    esp_err_t ret = i2c_host_exec(&dev->req[INA219_REQ_IDX_CURRENT]);
+    if (ret != ESP_OK) {
+        dev->cal_err = true;
+
+        return ret;
+    }
 
-    ina219_conf.rst  = 0;
-    ina219_conf.brng = BRNG_16V_FSR;
-    ina219_conf.pg   = PGA_GAIN_1_40MV;
-    ina219_conf.badc = ADC_RES_12BIT_128S;
-    ina219_conf.sadc = ADC_RES_12BIT_128S;
-    ina219_conf.mode = MODE_SHUNT_AND_BUS_CONTINUOUS;
+    *current = ina219_get_be16(dev->buff[INA219_OP_IDX_CUR]) * dev->cur_lsb;
 
-    ina219_reg_write(INA219_REG_CALIBRATION, (const uint8_t *)&ina219_cal_val);
-    ina219_reg_write(INA219_REG_CONFIG, (const uint8_t *)&ina219_conf);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
 }
 
-float ina219_get_shunt_voltage_mv(void)
+esp_err_t ina219_read_current(ina219_t *dev, float *current)
 {
-    return (ina219_get_shunt_voltage_raw() * 0.01);
+    int32_t value = 0;
+
+    esp_err_t ret = ina219_read_current_ua(dev, &value);
+    if (ret == ESP_OK) {
+        *current = value / 1000.0f;
+    }
+
+    return ret;
 }
 
-float ina219_get_bus_voltage_mv(void)
+esp_err_t ina219_update(ina219_t *dev)
 {
-    return ina219_get_bus_voltage_raw();
+#ifdef CONFIG_ENABLE_POWER_MONITOR
+    esp_err_t ret = ESP_OK;
+    int16_t bus = 0, cur = 0, pwr = 0;
+
+    if (dev->cal_err) {
+        if ((ret = ina219_verify_calibration(dev)) != ESP_OK) {
+            return ret;
+        }
+
+        dev->cal_err = false;
+    }
+
+    // the bus voltage register carries the CNVR and OVF flags along with the result,
+    // the callbacks chain the current and power fetch and the trigger onto it
+    if ((ret = i2c_host_exec(&dev->req[INA219_REQ_IDX_POLL])) != ESP_OK) {
+        goto err;
+    }
+
+    bus = ina219_get_be16(dev->buff[INA219_OP_IDX_BUS]);
+
+    if (!(bus & INA219_BUS_CNVR)) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+
+    cur = ina219_get_be16(dev->buff[INA219_OP_IDX_CUR]);
+    pwr = ina219_get_be16(dev->buff[INA219_OP_IDX_PWR]);
+
+    if (dev->discard) {
+        dev->discard = false;
+
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (!(bus & INA219_BUS_OVF)) {
+        dev->bus_uv = ((uint16_t)bus >> 3) * INA219_BUS_LSB;
+        dev->cur_ua = cur * dev->cur_lsb;
+        dev->pwr_uw = (uint16_t)pwr * dev->cur_lsb * INA219_PWR_LSB_MUL;
+    }
+
+    if (dev->auto_range && ina219_auto_range_step(dev, bus, cur)) {
+        return (bus & INA219_BUS_OVF) ? ESP_ERR_INVALID_STATE : ESP_OK;
+    }
+
+    if (bus & INA219_BUS_OVF) {
+        ESP_LOGW(TAG, "0x%02X: math overflow", dev->addr);
+
+        ret = ESP_ERR_INVALID_RESPONSE;
+        goto err;
+    }
+
+    return ESP_OK;
+
+err:
+    dev->cal_err = true;
+
+    return ret;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
 }
 
-float ina219_get_current_ma(void)
+uint8_t ina219_get_count(void)
 {
-    return (ina219_get_current_raw() / ina219_cur_div);
+    return ina219_num;
 }
 
-float ina219_get_power_mw(void)
+ina219_t *ina219_get(uint8_t idx)
 {
-    return (ina219_get_power_raw() * ina219_pwr_mul);
+    return (idx < ina219_num) ? &ina219_dev[idx] : NULL;
 }
 
 void ina219_init(void)
 {
-    ina219_set_calibration_32v_2a();
+#ifdef CONFIG_ENABLE_POWER_MONITOR
+    for (uint8_t addr = INA219_ADDR_MIN; addr <= INA219_ADDR_MAX && ina219_num < INA219_NUM_MAX; addr++) {
+        if (!ina219_probe(addr)) {
+            continue;
+        }
+
+        ina219_t *dev = &ina219_dev[ina219_num++];
+
+        ina219_dev_setup(dev, addr);
+
+#ifdef CONFIG_ENABLE_POWER_MONITOR_AUTO_RANGE
+        ina219_set_auto_range(dev);
+#else
+        ina219_set_calibration_32v_2a(dev);
+#endif
+
+        ESP_LOGI(TAG, "found sensor at 0x%02X", addr);
+    }
+#endif
 
-    ESP_LOGI(TAG, "initialized.");
+    ESP_LOGI(TAG, "initialized, %u sensor(s).", ina219_num);
 }
@@ -5,6 +5,8 @@
  *      Author: Jack Chen <redchenjs@live.com>
  */
 
+#include <string.h>
+
 #include "esp_log.h"
 
 #include "driver/gpio.h"
@@ -18,8 +20,24 @@
 
 #define TAG "st7789"
 
+#define ST7789_POLLING_SIZE 64
+
 static spi_transaction_t spi_trans[2] = {0};
 
+static uint8_t spi_trans_idx = 0;
+static uint8_t spi_trans_cnt = 0;
+
+static void st7789_wait_trans(uint8_t n)
+{
+    spi_transaction_t *t = NULL;
+
+    while (spi_trans_cnt > n) {
+        spi_device_get_trans_result(spi_host, &t, portMAX_DELAY);
+
+        spi_trans_cnt--;
+    }
+}
+
 void st7789_init_board(void)
 {
 #if (CONFIG_LCD_RST_PIN < 0)
@@ -82,44 +100,87 @@ void st7789_setpin_reset(uint8_t val)
 #endif
 }
 
+static void st7789_transmit(const uint8_t *buff, uint32_t n, uint8_t dc)
+{
+    spi_transaction_t t = {0};
+
+    t.length = n * 8;
+    t.user = (void *)(uint32_t)dc;
+
+    if (n <= sizeof(t.tx_data)) {
+        memcpy(t.tx_data, buff, n);
+        t.flags = SPI_TRANS_USE_TXDATA;
+    } else {
+        t.tx_buffer = buff;
+    }
+
+    // short writes spin on the bus, long ones go through the DMA queue
+    if (n <= ST7789_POLLING_SIZE) {
+        spi_device_polling_transmit(spi_host, &t);
+    } else {
+        spi_device_transmit(spi_host, &t);
+    }
+}
+
 void st7789_write_cmd(uint8_t cmd)
 {
-    spi_trans[0].length = 8;
-    spi_trans[0].rxlength = 0;
-    spi_trans[0].tx_buffer = &cmd;
-    spi_trans[0].rx_buffer = NULL;
-    spi_trans[0].user = (void *)0;
-    spi_trans[0].flags = 0;
+    st7789_wait_trans(0);
 
-    spi_device_transmit(spi_host, &spi_trans[0]);
+    st7789_transmit(&cmd, 1, 0);
 }
 
 void st7789_write_data(uint8_t data)
 {
-    spi_trans[0].length = 8;
-    spi_trans[0].rxlength = 0;
-    spi_trans[0].tx_buffer = &data;
-    spi_trans[0].rx_buffer = NULL;
-    spi_trans[0].user = (void *)1;
-    spi_trans[0].flags = 0;
+    st7789_wait_trans(0);
 
-    spi_device_transmit(spi_host, &spi_trans[0]);
+    st7789_transmit(&data, 1, 1);
+}
+
+void st7789_write_cmd_data(uint8_t cmd, const uint8_t *data, uint32_t n)
+{
+    st7789_wait_trans(0);
+
+    spi_device_acquire_bus(spi_host, portMAX_DELAY);
+
+    st7789_transmit(&cmd, 1, 0);
+
+    if (n != 0) {
+        st7789_transmit(data, n, 1);
+    }
+
+    spi_device_release_bus(spi_host);
 }
 
 void st7789_write_buff(uint8_t *buff, uint32_t n)
 {
-    spi_trans[0].length = n * 8;
-    spi_trans[0].rxlength = 0;
-    spi_trans[0].tx_buffer = buff;
-    spi_trans[0].rx_buffer = NULL;
-    spi_trans[0].user = (void *)1;
-    spi_trans[0].flags = 0;
+    st7789_wait_trans(0);
 
-    spi_device_transmit(spi_host, &spi_trans[0]);
+    st7789_transmit(buff, n, 1);
+}
+
+void st7789_write_strip(uint8_t *buff, uint32_t n)
+{
+    spi_transaction_t *t = &spi_trans[spi_trans_idx];
+
+    t->length = n * 8;
+    t->rxlength = 0;
+    t->tx_buffer = buff;
+    t->rx_buffer = NULL;
+    t->user = (void *)1;
+    t->flags = 0;
+
+    spi_device_queue_trans(spi_host, t, portMAX_DELAY);
+
+    spi_trans_idx = !spi_trans_idx;
+    spi_trans_cnt++;
+
+    st7789_wait_trans(1);
 }
 
 void st7789_refresh_gram(uint8_t *gram)
 {
+    st7789_wait_trans(0);
+
     spi_trans[0].length = 8;
     spi_trans[0].rxlength = 0;
     spi_trans[0].tx_data[0] = ST7789_RAMWR;
@@ -137,5 +198,7 @@ void st7789_refresh_gram(uint8_t *gram)
     spi_trans[1].flags = 0;
 
     spi_device_queue_trans(spi_host, &spi_trans[1], portMAX_DELAY);
+
+    spi_trans_cnt += 2;
 }
 #endif
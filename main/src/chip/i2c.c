@@ -7,23 +7,220 @@
 
 #include "esp_log.h"
 
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
 #include "chip/i2c.h"
 
+#define I2C_HOST_QUEUE_LEN   8
+#define I2C_HOST_CLK_SPEED   400000
+#define I2C_HOST_WAIT_MARGIN 100    // in ms, for the requests queued ahead, follow-ups and a bus recovery
+
 #ifdef CONFIG_ENABLE_POWER_MONITOR
-void i2c_host_init(void)
+static QueueHandle_t i2c_host_queue = NULL;
+
+static esp_err_t i2c_host_setup(void)
 {
+    esp_err_t ret = ESP_OK;
+
     i2c_config_t i2c_conf = {
         .mode = I2C_MODE_MASTER,
         .sda_io_num = CONFIG_I2C_SDA_PIN,
         .scl_io_num = CONFIG_I2C_SCL_PIN,
         .sda_pullup_en = GPIO_PULLUP_ENABLE,
         .scl_pullup_en = GPIO_PULLUP_ENABLE,
-        .master.clk_speed = 400000
+        .master.clk_speed = I2C_HOST_CLK_SPEED
     };
-    ESP_ERROR_CHECK(i2c_param_config(I2C_HOST_NUM, &i2c_conf));
-    ESP_ERROR_CHECK(i2c_driver_install(I2C_HOST_NUM, i2c_conf.mode, 0, 0, 0));
-    ESP_ERROR_CHECK(i2c_set_timeout(I2C_HOST_NUM, 80 * (I2C_APB_CLK_FREQ / i2c_conf.master.clk_speed)));
 
-    ESP_LOGI(I2C_HOST_TAG, "initialized, sda: %d, scl: %d", i2c_conf.sda_io_num, i2c_conf.scl_io_num);
+    if ((ret = i2c_param_config(I2C_HOST_NUM, &i2c_conf)) != ESP_OK) {
+        return ret;
+    }
+
+    if ((ret = i2c_driver_install(I2C_HOST_NUM, i2c_conf.mode, 0, 0, 0)) != ESP_OK) {
+        return ret;
+    }
+
+    return i2c_set_timeout(I2C_HOST_NUM, 80 * (I2C_APB_CLK_FREQ / i2c_conf.master.clk_speed));
+}
+
+// a slave stuck in the middle of a read holds SDA low until it is clocked out
+static void i2c_host_recover(void)
+{
+    ESP_LOGW(I2C_HOST_TAG, "recovering bus");
+
+    i2c_driver_delete(I2C_HOST_NUM);
+
+    gpio_reset_pin(CONFIG_I2C_SDA_PIN);
+    gpio_reset_pin(CONFIG_I2C_SCL_PIN);
+
+    gpio_set_level(CONFIG_I2C_SDA_PIN, 1);
+    gpio_set_level(CONFIG_I2C_SCL_PIN, 1);
+    gpio_set_direction(CONFIG_I2C_SDA_PIN, GPIO_MODE_INPUT_OUTPUT_OD);
+    gpio_set_direction(CONFIG_I2C_SCL_PIN, GPIO_MODE_OUTPUT_OD);
+
+    for (int i = 0; i < 9 && !gpio_get_level(CONFIG_I2C_SDA_PIN); i++) {
+        gpio_set_level(CONFIG_I2C_SCL_PIN, 0);
+        vTaskDelay(1);
+        gpio_set_level(CONFIG_I2C_SCL_PIN, 1);
+        vTaskDelay(1);
+    }
+
+    // stop condition
+    gpio_set_level(CONFIG_I2C_SDA_PIN, 0);
+    vTaskDelay(1);
+    gpio_set_level(CONFIG_I2C_SDA_PIN, 1);
+
+    // the request has failed already, a later one tries again
+    esp_err_t ret = i2c_host_setup();
+    if (ret != ESP_OK) {
+        ESP_LOGE(I2C_HOST_TAG, "bus setup failed: %s", esp_err_to_name(ret));
+    }
+}
+
+static i2c_cmd_handle_t i2c_host_build(const i2c_host_req_t *req)
+{
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+
+    // every op gets its own start, the ops are joined by repeated starts
+    for (int i = 0; i < req->num; i++) {
+        const i2c_host_op_t *op = &req->ops[i];
+
+        i2c_master_start(cmd);
+
+        i2c_master_write_byte(cmd, req->addr << 1 | I2C_MASTER_WRITE, true);
+        i2c_master_write_byte(cmd, op->reg, true);
+
+        if (op->write) {
+            i2c_master_write(cmd, op->data, op->len, true);
+        } else {
+            i2c_master_start(cmd);
+
+            i2c_master_write_byte(cmd, req->addr << 1 | I2C_MASTER_READ, true);
+            i2c_master_read(cmd, op->data, op->len, I2C_MASTER_LAST_NACK);
+        }
+    }
+
+    i2c_master_stop(cmd);
+
+    return cmd;
+}
+
+static esp_err_t i2c_host_run(i2c_host_req_t *req)
+{
+    if (!req->cmd) {
+        req->cmd = i2c_host_build(req);
+    }
+
+    esp_err_t ret = i2c_master_cmd_begin(I2C_HOST_NUM, req->cmd, req->timeout / portTICK_RATE_MS);
+
+    // a NACK is the slave's answer, anything else may have left the bus in a bad state
+    if (ret != ESP_OK && ret != ESP_FAIL) {
+        ESP_LOGE(I2C_HOST_TAG, "transfer to 0x%02X failed: %s", req->addr, esp_err_to_name(ret));
+
+        i2c_host_recover();
+    }
+
+    return ret;
+}
+
+static void i2c_host_task(void *pvParameter)
+{
+    i2c_host_req_t *head = NULL;
+
+    ESP_LOGI(I2C_HOST_TAG, "started.");
+
+    while (1) {
+        xQueueReceive(i2c_host_queue, &head, portMAX_DELAY);
+
+        // follow-ups go out right away, so a chain is one wake-up for its submitter
+        i2c_host_req_t *req = head;
+        do {
+            req->ret = i2c_host_run(req);
+
+            head->ret = req->ret;
+        } while (req->cb && (req = req->cb(req->ret, req->arg)));
+
+        if (head->busy) {
+            xSemaphoreGive(head->done);
+        }
+    }
+}
+
+esp_err_t i2c_host_submit(i2c_host_req_t *req)
+{
+    if (xQueueSend(i2c_host_queue, &req, req->timeout / portTICK_RATE_MS) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    return ESP_OK;
+}
+
+// runs a request and its follow-ups, returns the result of the last one
+esp_err_t i2c_host_exec(i2c_host_req_t *req)
+{
+    if (!req->done && !(req->done = xSemaphoreCreateBinary())) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    // a request that timed out may still be queued or on the bus, its completion is taken here
+    if (req->busy) {
+        if (xSemaphoreTake(req->done, 0) != pdTRUE) {
+            return ESP_ERR_TIMEOUT;
+        }
+
+        req->busy = false;
+    }
+
+    req->busy = true;
+
+    esp_err_t ret = i2c_host_submit(req);
+    if (ret != ESP_OK) {
+        req->busy = false;
+
+        return ret;
+    }
+
+    if (xSemaphoreTake(req->done, (req->timeout + I2C_HOST_WAIT_MARGIN) / portTICK_RATE_MS) != pdTRUE) {
+        ESP_LOGE(I2C_HOST_TAG, "request to 0x%02X timed out", req->addr);
+
+        return ESP_ERR_TIMEOUT;
+    }
+
+    req->busy = false;
+
+    return req->ret;
+}
+
+// frees the resources of a request that will not be submitted again, unless it is still pending
+void i2c_host_release(i2c_host_req_t *req)
+{
+    if (req->busy && xSemaphoreTake(req->done, 0) != pdTRUE) {
+        return;
+    }
+
+    req->busy = false;
+
+    if (req->done) {
+        vSemaphoreDelete(req->done);
+        req->done = NULL;
+    }
+
+    if (req->cmd) {
+        i2c_cmd_link_delete(req->cmd);
+        req->cmd = NULL;
+    }
+}
+
+void i2c_host_init(void)
+{
+    ESP_ERROR_CHECK(i2c_host_setup());
+
+    i2c_host_queue = xQueueCreate(I2C_HOST_QUEUE_LEN, sizeof(i2c_host_req_t *));
+
+    xTaskCreatePinnedToCore(i2c_host_task, "i2cT", 1920, NULL, 9, NULL, 0);
+
+    ESP_LOGI(I2C_HOST_TAG, "initialized, sda: %d, scl: %d", CONFIG_I2C_SDA_PIN, CONFIG_I2C_SCL_PIN);
 }
 #endif
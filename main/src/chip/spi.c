@@ -21,7 +21,11 @@ void spi_host_init(void)
         .sclk_io_num = CONFIG_SPI_SCLK_PIN,
         .quadwp_io_num = -1,
         .quadhd_io_num = -1,
+#ifdef CONFIG_LCD_RENDER_MODE_STRIP
+        .max_transfer_sz = ST7789_STRIP_SIZE * 2
+#else
         .max_transfer_sz = ST7789_SCREEN_WIDTH * ST7789_SCREEN_HEIGHT * 2
+#endif
     };
     ESP_ERROR_CHECK(spi_bus_initialize(SPI_HOST_NUM, &bus_conf, 1));
 
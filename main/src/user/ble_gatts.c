@@ -5,6 +5,7 @@
  *      Author: Jack Chen <redchenjs@live.com>
  */
 
+#include <math.h>
 #include <string.h>
 
 #include "esp_log.h"
@@ -18,6 +19,8 @@
 
 #include "user/ota.h"
 #include "user/fan.h"
+#include "user/meter.h"
+#include "user/stats.h"
 #include "user/ble_app.h"
 #include "user/ble_gatts.h"
 
@@ -47,6 +50,32 @@ gatts_profile_inst_t gatts_profile_tbl[PROFILE_IDX_MAX] = {
     [PROFILE_IDX_CFG] = { .gatts_cb = profile_cfg_event_handler, .gatts_if = ESP_GATT_IF_NONE }
 };
 
+/*
+ * Answers a read or a read blob with the part of the value from the requested offset on.
+ * The stack cuts the response down to the MTU and the client reads on at the next offset.
+ */
+static void gatts_send_read_rsp(esp_gatt_if_t gatts_if, esp_ble_gatts_cb_param_t *param, const uint8_t *value, uint16_t len)
+{
+    esp_gatt_rsp_t rsp = {0};
+    uint16_t offset = param->read.is_long ? param->read.offset : 0;
+
+    if (len > ESP_GATT_MAX_ATTR_LEN) {
+        len = ESP_GATT_MAX_ATTR_LEN;
+    }
+
+    if (offset > len) {
+        esp_ble_gatts_send_response(gatts_if, param->read.conn_id, param->read.trans_id, ESP_GATT_INVALID_OFFSET, NULL);
+        return;
+    }
+
+    rsp.attr_value.handle = param->read.handle;
+    rsp.attr_value.offset = offset;
+    rsp.attr_value.len = len - offset;
+    memcpy(rsp.attr_value.value, value + offset, rsp.attr_value.len);
+
+    esp_ble_gatts_send_response(gatts_if, param->read.conn_id, param->read.trans_id, ESP_GATT_OK, &rsp);
+}
+
 static void profile_ota_event_handler(esp_gatts_cb_event_t event, esp_gatt_if_t gatts_if, esp_ble_gatts_cb_param_t *param)
 {
     switch (event) {
@@ -59,22 +88,14 @@ static void profile_ota_event_handler(esp_gatts_cb_event_t event, esp_gatt_if_t
         esp_ble_gatts_create_service(gatts_if, &gatts_profile_tbl[PROFILE_IDX_OTA].service_id, GATTS_NUM_HANDLE_OTA);
 
         break;
-    case ESP_GATTS_READ_EVT: {
-        esp_gatt_rsp_t rsp = {0};
-
+    case ESP_GATTS_READ_EVT:
         if (param->read.handle == gatts_profile_tbl[PROFILE_IDX_OTA].descr_handle) {
-            rsp.attr_value.len = 2;
-            memcpy(rsp.attr_value.value, &desc_val_ota, sizeof(desc_val_ota));
+            gatts_send_read_rsp(gatts_if, param, (const uint8_t *)&desc_val_ota, sizeof(desc_val_ota));
         } else {
-            rsp.attr_value.len = strlen(app_get_version()) < (ESP_GATT_DEF_BLE_MTU_SIZE - 3) ?
-                                 strlen(app_get_version()) : (ESP_GATT_DEF_BLE_MTU_SIZE - 3);
-            memcpy(rsp.attr_value.value, app_get_version(), rsp.attr_value.len);
+            gatts_send_read_rsp(gatts_if, param, (const uint8_t *)app_get_version(), strlen(app_get_version()));
         }
 
-        esp_ble_gatts_send_response(gatts_if, param->read.conn_id, param->read.trans_id, ESP_GATT_OK, &rsp);
-
         break;
-    }
     case ESP_GATTS_WRITE_EVT:
         if (!param->write.is_prep) {
             if (param->write.handle == gatts_profile_tbl[PROFILE_IDX_OTA].descr_handle) {
@@ -160,6 +181,79 @@ static void profile_ota_event_handler(esp_gatts_cb_event_t event, esp_gatt_if_t
     }
 }
 
+// the status read by the app: fan setting, readings, totals and the selected statistics
+static void profile_cfg_read_value(uint8_t *value)
+{
+    fan_conf_t *fan = fan_get_conf();
+    meter_data_t meter = {0};
+    uint16_t voltage = 0, power = 0;
+    int16_t current = 0;
+
+    meter_get_data(0, &meter);
+
+    voltage = (meter.voltage < 0.0f) ? 0 : ((meter.voltage > 65535.0f) ? 65535 : meter.voltage + 0.5f);
+    current = (meter.current < -32768.0f) ? -32768 : ((meter.current > 32767.0f) ? 32767 : lroundf(meter.current));
+    power   = (meter.power < 0.0f) ? 0 : ((meter.power > 65535.0f) ? 65535 : meter.power + 0.5f);
+
+    #ifdef CONFIG_ENABLE_FAN_RGB
+        value[0] = 0x05;
+    #else
+        value[0] = 0x04;
+    #endif
+    value[1] = fan->color_s;
+    value[2] = fan->color_h >> 8;
+    value[3] = fan->color_h & 0xff;
+    value[4] = fan->color_l >> 8;
+    value[5] = fan->color_l & 0xff;
+    value[6] = fan->duty;
+    value[7] = 0x00;
+    value[8] = voltage >> 8;
+    value[9] = voltage & 0xff;
+    value[10] = (uint16_t)current >> 8;
+    value[11] = (uint16_t)current & 0xff;
+    value[12] = power >> 8;
+    value[13] = power & 0xff;
+
+    // session and lifetime totals in mAh and mWh, big-endian
+    int32_t totals[4] = {
+        meter.session.charge  / METER_US_PER_HOUR,
+        meter.session.energy  / METER_US_PER_HOUR,
+        meter.lifetime.charge / METER_US_PER_HOUR,
+        meter.lifetime.energy / METER_US_PER_HOUR
+    };
+    for (int i = 0; i < 4; i++) {
+        value[14 + i * 4] = (uint32_t)totals[i] >> 24;
+        value[15 + i * 4] = (uint32_t)totals[i] >> 16 & 0xff;
+        value[16 + i * 4] = (uint32_t)totals[i] >> 8 & 0xff;
+        value[17 + i * 4] = (uint32_t)totals[i] & 0xff;
+    }
+
+    // the selected statistics, min/max/mean/std in thousandths of the source unit, big-endian
+    stats_src_t src = 0;
+    stats_win_t win = 0;
+    stats_result_t res = {0};
+
+    stats_get_sel(&src, &win);
+    stats_get(src, win, &res);
+
+    int32_t stats[4] = {
+        lroundf(res.min  * 1000.0f),
+        lroundf(res.max  * 1000.0f),
+        lroundf(res.mean * 1000.0f),
+        lroundf(res.std  * 1000.0f)
+    };
+    value[30] = src;
+    value[31] = win;
+    value[32] = res.count >> 8;
+    value[33] = res.count & 0xff;
+    for (int i = 0; i < 4; i++) {
+        value[34 + i * 4] = (uint32_t)stats[i] >> 24;
+        value[35 + i * 4] = (uint32_t)stats[i] >> 16 & 0xff;
+        value[36 + i * 4] = (uint32_t)stats[i] >> 8 & 0xff;
+        value[37 + i * 4] = (uint32_t)stats[i] & 0xff;
+    }
+}
+
 static void profile_cfg_event_handler(esp_gatts_cb_event_t event, esp_gatt_if_t gatts_if, esp_ble_gatts_cb_param_t *param)
 {
     switch (event) {
@@ -172,34 +266,21 @@ static void profile_cfg_event_handler(esp_gatts_cb_event_t event, esp_gatt_if_t
         esp_ble_gatts_create_service(gatts_if, &gatts_profile_tbl[PROFILE_IDX_CFG].service_id, GATTS_NUM_HANDLE_CFG);
 
         break;
-    case ESP_GATTS_READ_EVT: {
-        esp_gatt_rsp_t rsp = {0};
-
+    case ESP_GATTS_READ_EVT:
         if (param->read.handle == gatts_profile_tbl[PROFILE_IDX_CFG].descr_handle) {
-            rsp.attr_value.len = 2;
-            memcpy(rsp.attr_value.value, &desc_val_fan, sizeof(desc_val_fan));
+            gatts_send_read_rsp(gatts_if, param, (const uint8_t *)&desc_val_fan, sizeof(desc_val_fan));
         } else {
-            fan_conf_t *fan = fan_get_conf();
-
-            rsp.attr_value.len = 8;
-            #ifdef CONFIG_ENABLE_FAN_RGB
-                rsp.attr_value.value[0] = 0x05;
-            #else
-                rsp.attr_value.value[0] = 0x04;
-            #endif
-            rsp.attr_value.value[1] = fan->color_s;
-            rsp.attr_value.value[2] = fan->color_h >> 8;
-            rsp.attr_value.value[3] = fan->color_h & 0xff;
-            rsp.attr_value.value[4] = fan->color_l >> 8;
-            rsp.attr_value.value[5] = fan->color_l & 0xff;
-            rsp.attr_value.value[6] = fan->duty;
-            rsp.attr_value.value[7] = 0x00;
-        }
+            static uint8_t value[50] = {0};
+
+            // a long read goes on with the snapshot its first part came from
+            if (!param->read.is_long) {
+                profile_cfg_read_value(value);
+            }
 
-        esp_ble_gatts_send_response(gatts_if, param->read.conn_id, param->read.trans_id, ESP_GATT_OK, &rsp);
+            gatts_send_read_rsp(gatts_if, param, value, sizeof(value));
+        }
 
         break;
-    }
     case ESP_GATTS_WRITE_EVT:
         if (!param->write.is_prep) {
             if (param->write.handle == gatts_profile_tbl[PROFILE_IDX_CFG].descr_handle) {
@@ -225,6 +306,28 @@ static void profile_cfg_event_handler(esp_gatts_cb_event_t event, esp_gatt_if_t
                         ESP_LOGE(GATTS_CFG_TAG, "invalid command: 0x%02X", param->write.value[0]);
                     }
                     break;
+                case 0xEE:
+                    if (param->write.len == 1) {            // reset session energy totals
+                        meter_reset_session();
+                    } else {
+                        ESP_LOGE(GATTS_CFG_TAG, "invalid command: 0x%02X", param->write.value[0]);
+                    }
+                    break;
+                case 0xED:
+                    if (param->write.len == 3) {            // set power monitor adc resolution/averaging and mode
+                        meter_set_adc(param->write.value[1] & 0x0F,
+                                      param->write.value[2] ? INA219_MODE_IDX_TRIGGERED : INA219_MODE_IDX_CONTINUOUS);
+                    } else {
+                        ESP_LOGE(GATTS_CFG_TAG, "invalid command: 0x%02X", param->write.value[0]);
+                    }
+                    break;
+                case 0xEC:
+                    if (param->write.len == 3) {            // select the statistics source and window
+                        stats_set_sel(param->write.value[1], param->write.value[2]);
+                    } else {
+                        ESP_LOGE(GATTS_CFG_TAG, "invalid command: 0x%02X", param->write.value[0]);
+                    }
+                    break;
                 default:
                     ESP_LOGW(GATTS_CFG_TAG, "unknown command: 0x%02X", param->write.value[0]);
                     break;
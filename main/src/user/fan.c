@@ -21,6 +21,8 @@
 #include "user/ec.h"
 #include "user/fan.h"
 #include "user/pwr.h"
+#include "user/gui.h"
+#include "user/ripple.h"
 
 #define TAG "fan"
 
@@ -257,6 +259,11 @@ static void fan_task(void *pvParameter)
                     fan_set_conf(&fan_conf);
                     break;
                 }
+#ifdef CONFIG_ENABLE_GUI
+                case EC_EVT_N_B:
+                    gui_set_page(gui_get_page() + 1);
+                    break;
+#endif
 #endif
                 case 0xff:
                     if (rpm_cnt++ == 3) {
@@ -287,6 +294,18 @@ static void fan_task(void *pvParameter)
 }
 
 uint16_t fan_get_rpm(void)
+{
+#ifdef CONFIG_ENABLE_FAN_SENSORLESS_RPM
+    // 3-pin fans without a usable tach line are measured by their current ripple
+    if (!fan_rpm) {
+        return ripple_get_rpm();
+    }
+#endif
+
+    return fan_rpm;
+}
+
+uint16_t fan_get_tach_rpm(void)
 {
     return fan_rpm;
 }
@@ -7,45 +7,565 @@
 
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "esp_log.h"
+#include "esp_timer.h"
 
 #include "driver/gpio.h"
 
 #include "gfx.h"
+#include "drivers/gdisp/ST7789/ST7789.h"
 
 #include "core/os.h"
-#include "board/ina219.h"
 
 #include "user/pwr.h"
 #include "user/fan.h"
 #include "user/gui.h"
+#include "user/meter.h"
+#include "user/stats.h"
 
 #define TAG "gui"
 
+#define GUI_GRAPH_X         48
+#define GUI_GRAPH_WIDTH     192
+#define GUI_GRAPH_BAND      45
+#define GUI_GRAPH_PERIOD    10      // in frames, 200 ms per sample
+
+#define GUI_GRAPH_RPM_MAX   4000
+#define GUI_GRAPH_PWR_MAX   12000   // in mW
+
+#define GUI_FIELD_WIDTH     143
+#define GUI_FIELD_HEIGHT    32
+
+typedef struct {
+    uint8_t  duty;
+    uint16_t rpm;
+    uint16_t pwr;
+} gui_sample_t;
+
+typedef enum {
+    GUI_FIELD_IDX_DUTY    = 0x00,
+    GUI_FIELD_IDX_RPM     = 0x01,
+    GUI_FIELD_IDX_MODE    = 0x02,
+    GUI_FIELD_IDX_VOLTAGE = 0x03,
+    GUI_FIELD_IDX_CURRENT = 0x04,
+
+    GUI_FIELD_IDX_SES_CHARGE = 0x05,
+    GUI_FIELD_IDX_SES_ENERGY = 0x06,
+    GUI_FIELD_IDX_TOT_ENERGY = 0x07,
+    GUI_FIELD_IDX_TOT_CHARGE = 0x08,
+    GUI_FIELD_IDX_POWER      = 0x09,
+
+    GUI_FIELD_IDX_STAT_MIN = 0x0A,
+    GUI_FIELD_IDX_STAT_MAX = 0x0B,
+    GUI_FIELD_IDX_STAT_AVG = 0x0C,
+    GUI_FIELD_IDX_STAT_SEL = 0x0D,
+    GUI_FIELD_IDX_STAT_STD = 0x0E,
+
+    GUI_FIELD_IDX_MAX
+} gui_field_idx_t;
+
+typedef struct {
+    coord_t x;
+    coord_t y;
+    coord_t cx;
+    color_t color;
+    char text[16];
+} gui_field_t;
+
+#ifdef CONFIG_GUI_PROFILE
+typedef enum {
+    GUI_PROF_IDX_FRAME = 0x00,
+    GUI_PROF_IDX_FIELD = 0x01,
+    GUI_PROF_IDX_GRAPH = 0x02,
+    GUI_PROF_IDX_FLUSH = 0x03,
+
+    GUI_PROF_IDX_MAX
+} gui_prof_idx_t;
+
+typedef struct {
+    uint32_t cnt;
+    uint32_t sum;   // in us
+    uint32_t max;   // in us
+} gui_prof_t;
+
+static const char *gui_prof_str[GUI_PROF_IDX_MAX] = {
+    [GUI_PROF_IDX_FRAME] = "frame",
+    [GUI_PROF_IDX_FIELD] = "field",
+    [GUI_PROF_IDX_GRAPH] = "graph",
+    [GUI_PROF_IDX_FLUSH] = "flush",
+};
+
+static gui_prof_t gui_prof[GUI_PROF_IDX_MAX] = {0};
+static uint32_t gui_prof_bytes = 0;
+static int64_t gui_prof_time = 0;
+
+#define GUI_PROF_BEGIN(t)       int64_t t = esp_timer_get_time()
+#define GUI_PROF_END(idx, t)    gui_prof_add(idx, t)
+#else
+#define GUI_PROF_BEGIN(t)
+#define GUI_PROF_END(idx, t)
+#endif
+
 GDisplay *gui_gdisp = NULL;
 
-static GTimer gui_flush_timer;
+static font_t gui_font;
+static font_t gui_font_small;
 
 static gui_mode_t gui_mode = GUI_MODE_IDX_ON;
+static gui_page_t gui_page = GUI_PAGE_IDX_INFO;
+
+static gui_sample_t gui_hist[GUI_GRAPH_WIDTH] = {0};
+static uint16_t gui_hist_head = 0;
+
+// the last text drawn in each field, a field is only redrawn when it changes
+static gui_field_t gui_field[GUI_FIELD_IDX_MAX] = {
+    [GUI_FIELD_IDX_DUTY]    = {  95,   2, 143 },
+    [GUI_FIELD_IDX_RPM]     = {  95,  34, 143 },
+    [GUI_FIELD_IDX_MODE]    = {  95,  67, 143 },
+    [GUI_FIELD_IDX_VOLTAGE] = {   2, 100, 118 },
+    [GUI_FIELD_IDX_CURRENT] = { 120, 100, 118 },
+
+    [GUI_FIELD_IDX_SES_CHARGE] = {  95,   2, 143 },
+    [GUI_FIELD_IDX_SES_ENERGY] = {  95,  34, 143 },
+    [GUI_FIELD_IDX_TOT_ENERGY] = {  95,  67, 143 },
+    [GUI_FIELD_IDX_TOT_CHARGE] = {   2, 100, 118 },
+    [GUI_FIELD_IDX_POWER]      = { 120, 100, 118 },
+
+    [GUI_FIELD_IDX_STAT_MIN] = {  95,   2, 143 },
+    [GUI_FIELD_IDX_STAT_MAX] = {  95,  34, 143 },
+    [GUI_FIELD_IDX_STAT_AVG] = {  95,  67, 143 },
+    [GUI_FIELD_IDX_STAT_SEL] = {   2, 100, 118 },
+    [GUI_FIELD_IDX_STAT_STD] = { 120, 100, 118 },
+};
+
+static const char *gui_stats_src_str[STATS_SRC_IDX_MAX] = {
+    [STATS_SRC_IDX_VOLTAGE] = "V",
+    [STATS_SRC_IDX_CURRENT] = "A",
+    [STATS_SRC_IDX_POWER]   = "W",
+    [STATS_SRC_IDX_RPM]     = "RPM",
+};
+
+static const char *gui_stats_win_str[STATS_WIN_IDX_MAX] = {
+    [STATS_WIN_IDX_1S]   = "1s",
+    [STATS_WIN_IDX_10S]  = "10s",
+    [STATS_WIN_IDX_1MIN] = "1m",
+};
+
+// fields are composed here and then blitted as one rectangle
+static GDisplay *gui_field_pixmap = NULL;
+
+#ifdef CONFIG_GUI_PROFILE
+static void gui_prof_add(gui_prof_idx_t idx, int64_t t0)
+{
+    uint32_t t = esp_timer_get_time() - t0;
+
+    gui_prof[idx].cnt++;
+    gui_prof[idx].sum += t;
+    if (t > gui_prof[idx].max) {
+        gui_prof[idx].max = t;
+    }
+}
 
-static void gui_flush_task(void *pvParameter)
+static void gui_prof_report(void)
 {
+    int64_t now = esp_timer_get_time();
+    uint32_t elapsed = now - gui_prof_time;
+
+    if (elapsed < CONFIG_GUI_PROFILE_INTERVAL * 1000000) {
+        return;
+    }
+
+    // the counters are updated without a lock, a report may be off by one sample
+    ESP_LOGI(TAG, "profile: %u.%02u fps, %u bytes/s drawn",
+             (uint32_t)((uint64_t)gui_prof[GUI_PROF_IDX_FRAME].cnt * 100000000 / elapsed) / 100,
+             (uint32_t)((uint64_t)gui_prof[GUI_PROF_IDX_FRAME].cnt * 100000000 / elapsed) % 100,
+             (uint32_t)((uint64_t)gui_prof_bytes * 1000000 / elapsed));
+
+    for (int i = 0; i < GUI_PROF_IDX_MAX; i++) {
+        ESP_LOGI(TAG, "profile: %s: %u calls, avg %u us, max %u us", gui_prof_str[i], gui_prof[i].cnt,
+                 gui_prof[i].cnt ? gui_prof[i].sum / gui_prof[i].cnt : 0, gui_prof[i].max);
+    }
+
+    memset(gui_prof, 0x00, sizeof(gui_prof));
+    gui_prof_bytes = 0;
+    gui_prof_time = now;
+}
+#endif
+
+static void gui_flush(void)
+{
+    GUI_PROF_BEGIN(t0);
+
     gdispGFlush(gui_gdisp);
+
+    GUI_PROF_END(GUI_PROF_IDX_FLUSH, t0);
 }
 
-static void gui_task(void *pvParameter)
+static void gui_hist_push(void)
+{
+    gui_sample_t *sample = &gui_hist[gui_hist_head];
+
+    meter_data_t meter = {0};
+    meter_get_data(0, &meter);
+
+    float power = meter.power;
+
+    sample->duty = fan_get_conf()->duty;
+    sample->rpm  = fan_get_rpm();
+    sample->pwr  = (power < 0.0) ? 0 : ((power > 65535.0) ? 65535 : power);
+
+    gui_hist_head = (gui_hist_head + 1) % GUI_GRAPH_WIDTH;
+}
+
+static coord_t gui_graph_y(uint8_t band, uint32_t val, uint32_t max)
+{
+    if (val > max) {
+        val = max;
+    }
+
+    return band * GUI_GRAPH_BAND + (GUI_GRAPH_BAND - 2) - val * (GUI_GRAPH_BAND - 2) / max;
+}
+
+static void gui_graph_draw_column(uint16_t idx, bool connect)
+{
+    const gui_sample_t *cur = &gui_hist[idx];
+    const gui_sample_t *pre = connect ? &gui_hist[(idx + GUI_GRAPH_WIDTH - 1) % GUI_GRAPH_WIDTH] : cur;
+    coord_t x = GUI_GRAPH_X + idx;
+
+    // the column is drawn at its ring position, the panel scrolls it into place
+    gdispGFillArea(gui_gdisp, x, 0, 1, gdispGGetHeight(gui_gdisp), Black);
+
+    gdispGDrawLine(gui_gdisp, x, gui_graph_y(0, pre->duty, 255), x, gui_graph_y(0, cur->duty, 255), Yellow);
+    gdispGDrawLine(gui_gdisp, x, gui_graph_y(1, pre->rpm, GUI_GRAPH_RPM_MAX), x, gui_graph_y(1, cur->rpm, GUI_GRAPH_RPM_MAX), Cyan);
+    gdispGDrawLine(gui_gdisp, x, gui_graph_y(2, pre->pwr, GUI_GRAPH_PWR_MAX), x, gui_graph_y(2, cur->pwr, GUI_GRAPH_PWR_MAX), Magenta);
+}
+
+static void gui_graph_scroll(void)
+{
+    // the oldest sample sits at the head of the ring and goes to the left edge
+    gdispGControl(gui_gdisp, GDISP_CONTROL_ST7789_SCROLL_START, (void *)(uint32_t)gui_hist_head);
+}
+
+// writes val / 10^frac with frac decimal places, returns the end of the string
+static char *gui_fmt_fixed(char *buff, uint32_t val, uint8_t frac)
+{
+    char digits[12];
+    uint8_t n = 0;
+
+    // keep at least one digit in front of the point
+    do {
+        digits[n++] = '0' + val % 10;
+        val /= 10;
+    } while (val || n <= frac);
+
+    while (n) {
+        if (n == frac) {
+            *buff++ = '.';
+        }
+        *buff++ = digits[--n];
+    }
+    *buff = '\0';
+
+    return buff;
+}
+
+static char *gui_fmt_str(char *buff, const char *str)
+{
+    while (*str) {
+        *buff++ = *str++;
+    }
+    *buff = '\0';
+
+    return buff;
+}
+
+// an accumulated total in milli-units, dropping decimals as it grows to keep the width
+static char *gui_fmt_total(char *buff, int64_t val, const char *unit)
+{
+    uint64_t mag = (val < 0) ? -val : val;
+
+    if (val < 0) {
+        buff = gui_fmt_str(buff, "-");
+    }
+
+    if (mag < 100000) {
+        buff = gui_fmt_fixed(buff, mag, 3);
+    } else if (mag < 10000000) {
+        buff = gui_fmt_fixed(buff, (mag + 50) / 100, 1);
+    } else {
+        buff = gui_fmt_fixed(buff, (mag + 500) / 1000, 0);
+    }
+
+    return gui_fmt_str(buff, unit);
+}
+
+// a statistic in the unit of its source, with the resolution the info page uses
+static char *gui_fmt_stat(char *buff, stats_src_t src, float val)
+{
+    uint32_t mag = fabsf(val) + 0.5f;
+
+    if (val <= -0.5f) {
+        buff = gui_fmt_str(buff, "-");
+    }
+
+    switch (src) {
+    case STATS_SRC_IDX_VOLTAGE:
+        if (mag < 10000) {
+            buff = gui_fmt_fixed(buff, mag, 3);
+        } else {
+            buff = gui_fmt_fixed(buff, (mag + 5) / 10, 2);
+        }
+        return gui_fmt_str(buff, "V");
+    case STATS_SRC_IDX_CURRENT:
+        return gui_fmt_str(gui_fmt_fixed(buff, mag, 3), "A");
+    case STATS_SRC_IDX_POWER:
+        return gui_fmt_str(gui_fmt_fixed(buff, (mag + 5) / 10, 2), "W");
+    case STATS_SRC_IDX_RPM:
+    default:
+        return gui_fmt_fixed(buff, mag, 0);
+    }
+}
+
+static void gui_field_draw(gui_field_idx_t idx, const char *text, color_t color)
+{
+    gui_field_t *field = &gui_field[idx];
+
+    if (field->color == color && strncmp(field->text, text, sizeof(field->text)) == 0) {
+        return;
+    }
+
+    GUI_PROF_BEGIN(t0);
+
+    field->color = color;
+    strncpy(field->text, text, sizeof(field->text));
+
+    if (gui_field_pixmap) {
+        gdispGFillStringBox(gui_field_pixmap, 0, 0, field->cx, GUI_FIELD_HEIGHT, text, gui_font, color, Black, justifyRight);
+        gdispGBlitArea(gui_gdisp, field->x, field->y, field->cx, GUI_FIELD_HEIGHT, 0, 0, GUI_FIELD_WIDTH, gdispPixmapGetBits(gui_field_pixmap));
+    } else {
+        gdispGFillStringBox(gui_gdisp, field->x, field->y, field->cx, GUI_FIELD_HEIGHT, text, gui_font, color, Black, justifyRight);
+    }
+
+    GUI_PROF_END(GUI_PROF_IDX_FIELD, t0);
+#ifdef CONFIG_GUI_PROFILE
+    gui_prof_bytes += field->cx * GUI_FIELD_HEIGHT * sizeof(pixel_t);
+#endif
+}
+
+static void gui_page_init(gui_page_t page)
 {
-    font_t gui_font;
     char text_buff[32] = {0};
+
+    gdispGClear(gui_gdisp, Black);
+
+    switch (page) {
+    case GUI_PAGE_IDX_GRAPH:
+        gdispGControl(gui_gdisp, GDISP_CONTROL_ST7789_SCROLL_AREA, ST7789_SCROLL_AREA(GUI_GRAPH_X, GUI_GRAPH_WIDTH));
+
+        snprintf(text_buff, sizeof(text_buff), "PWM");
+        gdispGFillStringBox(gui_gdisp, 2, 0 * GUI_GRAPH_BAND + 4, 44, 16, text_buff, gui_font_small, Yellow, Black, justifyLeft);
+
+        snprintf(text_buff, sizeof(text_buff), "RPM");
+        gdispGFillStringBox(gui_gdisp, 2, 1 * GUI_GRAPH_BAND + 4, 44, 16, text_buff, gui_font_small, Cyan, Black, justifyLeft);
+
+        snprintf(text_buff, sizeof(text_buff), "PWR");
+        gdispGFillStringBox(gui_gdisp, 2, 2 * GUI_GRAPH_BAND + 4, 44, 16, text_buff, gui_font_small, Magenta, Black, justifyLeft);
+
+        for (uint16_t i = 0; i < GUI_GRAPH_WIDTH; i++) {
+            gui_graph_draw_column((gui_hist_head + i) % GUI_GRAPH_WIDTH, i != 0);
+        }
+
+        gui_graph_scroll();
+
+        break;
+    case GUI_PAGE_IDX_ENERGY:
+        gdispGControl(gui_gdisp, GDISP_CONTROL_ST7789_SCROLL_AREA, ST7789_SCROLL_AREA(0, 0));
+
+        snprintf(text_buff, sizeof(text_buff), "CHG:");
+        gdispGFillStringBox(gui_gdisp, 2, 2, 93, 32, text_buff, gui_font, Yellow, Black, justifyLeft);
+
+        snprintf(text_buff, sizeof(text_buff), "NRG:");
+        gdispGFillStringBox(gui_gdisp, 2, 34, 93, 32, text_buff, gui_font, Cyan, Black, justifyLeft);
+
+        snprintf(text_buff, sizeof(text_buff), "TOT:");
+        gdispGFillStringBox(gui_gdisp, 2, 67, 93, 32, text_buff, gui_font, Magenta, Black, justifyLeft);
+
+        // the screen was cleared, every field has to be drawn again
+        for (int i = 0; i < GUI_FIELD_IDX_MAX; i++) {
+            gui_field[i].text[0] = '\0';
+        }
+
+        break;
+    case GUI_PAGE_IDX_STATS:
+        gdispGControl(gui_gdisp, GDISP_CONTROL_ST7789_SCROLL_AREA, ST7789_SCROLL_AREA(0, 0));
+
+        snprintf(text_buff, sizeof(text_buff), "MIN:");
+        gdispGFillStringBox(gui_gdisp, 2, 2, 93, 32, text_buff, gui_font, Yellow, Black, justifyLeft);
+
+        snprintf(text_buff, sizeof(text_buff), "MAX:");
+        gdispGFillStringBox(gui_gdisp, 2, 34, 93, 32, text_buff, gui_font, Cyan, Black, justifyLeft);
+
+        snprintf(text_buff, sizeof(text_buff), "AVG:");
+        gdispGFillStringBox(gui_gdisp, 2, 67, 93, 32, text_buff, gui_font, Magenta, Black, justifyLeft);
+
+        // the screen was cleared, every field has to be drawn again
+        for (int i = 0; i < GUI_FIELD_IDX_MAX; i++) {
+            gui_field[i].text[0] = '\0';
+        }
+
+        break;
+    case GUI_PAGE_IDX_INFO:
+    default:
+        gdispGControl(gui_gdisp, GDISP_CONTROL_ST7789_SCROLL_AREA, ST7789_SCROLL_AREA(0, 0));
+
+        snprintf(text_buff, sizeof(text_buff), "PWM:");
+        gdispGFillStringBox(gui_gdisp, 2, 2, 93, 32, text_buff, gui_font, Yellow, Black, justifyLeft);
+
+        snprintf(text_buff, sizeof(text_buff), "RPM:");
+        gdispGFillStringBox(gui_gdisp, 2, 34, 93, 32, text_buff, gui_font, Cyan, Black, justifyLeft);
+
+        snprintf(text_buff, sizeof(text_buff), "PWR:");
+        gdispGFillStringBox(gui_gdisp, 2, 67, 93, 32, text_buff, gui_font, Magenta, Black, justifyLeft);
+
+        // the screen was cleared, every field has to be drawn again
+        for (int i = 0; i < GUI_FIELD_IDX_MAX; i++) {
+            gui_field[i].text[0] = '\0';
+        }
+
+        break;
+    }
+}
+
+static void gui_page_draw_info(void)
+{
+    char text_buff[32] = {0};
+
+    gui_fmt_str(gui_fmt_fixed(text_buff, fan_get_conf()->duty, 0), fan_env_saved() ? "" : "*");
+    gui_field_draw(GUI_FIELD_IDX_DUTY, text_buff, Yellow);
+
+    gui_fmt_fixed(text_buff, fan_get_rpm(), 0);
+    gui_field_draw(GUI_FIELD_IDX_RPM, text_buff, Cyan);
+
+    gui_fmt_str(gui_fmt_str(text_buff, pwr_get_mode_str()), pwr_env_saved() ? "" : "*");
+    gui_field_draw(GUI_FIELD_IDX_MODE, text_buff, Magenta);
+
+    meter_data_t meter = {0};
+    meter_get_data(0, &meter);
+
+    uint32_t voltage = fabsf(meter.voltage) + 0.5f;
+    if (voltage < 10000) {
+        gui_fmt_str(gui_fmt_fixed(text_buff, voltage, 3), "V");
+    } else {
+        gui_fmt_str(gui_fmt_fixed(text_buff, (voltage + 5) / 10, 2), "V");
+    }
+    gui_field_draw(GUI_FIELD_IDX_VOLTAGE, text_buff, Lime);
+
+    uint32_t current = fabsf(meter.current) + 0.5f;
+    gui_fmt_str(gui_fmt_fixed(text_buff, current, 3), "A");
+    if (meter.current < 0.0f) {
+        gui_field_draw(GUI_FIELD_IDX_CURRENT, text_buff, SkyBlue);
+    } else {
+        gui_field_draw(GUI_FIELD_IDX_CURRENT, text_buff, Orange);
+    }
+}
+
+static void gui_page_draw_energy(void)
+{
+    char text_buff[32] = {0};
+    meter_data_t meter = {0};
+
+    meter_get_data(0, &meter);
+
+    gui_fmt_total(text_buff, meter.session.charge / METER_US_PER_HOUR, "Ah");
+    gui_field_draw(GUI_FIELD_IDX_SES_CHARGE, text_buff, Yellow);
+
+    gui_fmt_total(text_buff, meter.session.energy / METER_US_PER_HOUR, "Wh");
+    gui_field_draw(GUI_FIELD_IDX_SES_ENERGY, text_buff, Cyan);
+
+    gui_fmt_total(text_buff, meter.lifetime.energy / METER_US_PER_HOUR, "Wh");
+    gui_field_draw(GUI_FIELD_IDX_TOT_ENERGY, text_buff, Magenta);
+
+    gui_fmt_total(text_buff, meter.lifetime.charge / METER_US_PER_HOUR, "Ah");
+    gui_field_draw(GUI_FIELD_IDX_TOT_CHARGE, text_buff, Lime);
+
+    gui_fmt_str(gui_fmt_fixed(text_buff, (uint32_t)(fabsf(meter.power) + 5.0f) / 10, 2), "W");
+    gui_field_draw(GUI_FIELD_IDX_POWER, text_buff, Orange);
+}
+
+static void gui_page_draw_stats(void)
+{
+    char text_buff[32] = {0};
+    stats_src_t src = 0;
+    stats_win_t win = 0;
+    stats_result_t res = {0};
+
+    stats_get_sel(&src, &win);
+    stats_get(src, win, &res);
+
+    gui_fmt_stat(text_buff, src, res.min);
+    gui_field_draw(GUI_FIELD_IDX_STAT_MIN, text_buff, Yellow);
+
+    gui_fmt_stat(text_buff, src, res.max);
+    gui_field_draw(GUI_FIELD_IDX_STAT_MAX, text_buff, Cyan);
+
+    gui_fmt_stat(text_buff, src, res.mean);
+    gui_field_draw(GUI_FIELD_IDX_STAT_AVG, text_buff, Magenta);
+
+    gui_fmt_str(gui_fmt_str(gui_fmt_str(text_buff, gui_stats_src_str[src]), "/"), gui_stats_win_str[win]);
+    gui_field_draw(GUI_FIELD_IDX_STAT_SEL, text_buff, Lime);
+
+    gui_fmt_stat(gui_fmt_str(text_buff, "~"), src, res.std);
+    gui_field_draw(GUI_FIELD_IDX_STAT_STD, text_buff, Orange);
+}
+
+static void gui_page_draw_graph(bool sampled)
+{
+    char text_buff[32] = {0};
+    const gui_sample_t *last = &gui_hist[(gui_hist_head + GUI_GRAPH_WIDTH - 1) % GUI_GRAPH_WIDTH];
+
+    if (sampled) {
+        GUI_PROF_BEGIN(t0);
+
+        gui_graph_draw_column((gui_hist_head + GUI_GRAPH_WIDTH - 1) % GUI_GRAPH_WIDTH, true);
+        gui_graph_draw_column(gui_hist_head, false);
+
+        gui_graph_scroll();
+
+        GUI_PROF_END(GUI_PROF_IDX_GRAPH, t0);
+#ifdef CONFIG_GUI_PROFILE
+        gui_prof_bytes += 2 * gdispGGetHeight(gui_gdisp) * sizeof(pixel_t);
+#endif
+    }
+
+    gui_fmt_fixed(text_buff, last->duty, 0);
+    gdispGFillStringBox(gui_gdisp, 2, 0 * GUI_GRAPH_BAND + 22, 44, 16, text_buff, gui_font_small, Yellow, Black, justifyRight);
+
+    gui_fmt_fixed(text_buff, last->rpm, 0);
+    gdispGFillStringBox(gui_gdisp, 2, 1 * GUI_GRAPH_BAND + 22, 44, 16, text_buff, gui_font_small, Cyan, Black, justifyRight);
+
+    gui_fmt_fixed(text_buff, last->pwr / 10, 2);
+    gdispGFillStringBox(gui_gdisp, 2, 2 * GUI_GRAPH_BAND + 22, 44, 16, text_buff, gui_font_small, Magenta, Black, justifyRight);
+}
+
+static void gui_task(void *pvParameter)
+{
+    bool first_frame = true;
+    uint8_t frame_cnt = 0;
+    gui_page_t page = GUI_PAGE_IDX_MAX;
     portTickType xLastWakeTime;
 
     gfxInit();
 
     gui_gdisp = gdispGetDisplay(0);
-    gui_font = gdispOpenFont("DejaVuSans32");
+    gui_font = gdispOpenFont("DejaVuSans32_aa");
+    gui_font_small = gdispOpenFont("DejaVuSans12");
 
-    gtimerStart(&gui_flush_timer, gui_flush_task, NULL, TRUE, TIME_INFINITE);
+    gui_field_pixmap = gdispPixmapCreate(GUI_FIELD_WIDTH, GUI_FIELD_HEIGHT);
+    if (!gui_field_pixmap) {
+        ESP_LOGW(TAG, "no memory for field pixmap, drawing fields directly");
+    }
 
     ESP_LOGI(TAG, "started.");
 
@@ -53,52 +573,69 @@ static void gui_task(void *pvParameter)
     gdispGSetOrientation(gui_gdisp, CONFIG_LCD_ROTATION_DEGREE);
 #endif
 
-    snprintf(text_buff, sizeof(text_buff), "PWM:");
-    gdispGFillStringBox(gui_gdisp, 2, 2, 93, 32, text_buff, gui_font, Yellow, Black, justifyLeft);
-
-    snprintf(text_buff, sizeof(text_buff), "RPM:");
-    gdispGFillStringBox(gui_gdisp, 2, 34, 93, 32, text_buff, gui_font, Cyan, Black, justifyLeft);
-
-    snprintf(text_buff, sizeof(text_buff), "PWR:");
-    gdispGFillStringBox(gui_gdisp, 2, 67, 93, 32, text_buff, gui_font, Magenta, Black, justifyLeft);
-
     while (1) {
         switch (gui_mode) {
-        case GUI_MODE_IDX_ON:
+        case GUI_MODE_IDX_ON: {
             xLastWakeTime = xTaskGetTickCount();
 
             gdispGSetBacklight(gui_gdisp, 255);
 
-            snprintf(text_buff, sizeof(text_buff), "%u%s", fan_get_conf()->duty, fan_env_saved() ? "" : "*");
-            gdispGFillStringBox(gui_gdisp, 95, 2, 143, 32, text_buff, gui_font, Yellow, Black, justifyRight);
+            bool sampled = false;
+            if (++frame_cnt == GUI_GRAPH_PERIOD) {
+                frame_cnt = 0;
+
+                gui_hist_push();
+
+                sampled = true;
+            }
+
+            GUI_PROF_BEGIN(t0);
 
-            snprintf(text_buff, sizeof(text_buff), "%u", fan_get_rpm());
-            gdispGFillStringBox(gui_gdisp, 95, 34, 143, 32, text_buff, gui_font, Cyan, Black, justifyRight);
+            gdispGBatchBegin(gui_gdisp);
 
-            snprintf(text_buff, sizeof(text_buff), "%s%s", pwr_get_mode_str(), pwr_env_saved() ? "" : "*");
-            gdispGFillStringBox(gui_gdisp, 95, 67, 143, 32, text_buff, gui_font, Magenta, Black, justifyRight);
+            if (page != gui_page) {
+                page = gui_page;
 
-            float voltage = ina219_get_bus_voltage_mv() * 0.001;
-            if (voltage < 10.00) {
-                snprintf(text_buff, sizeof(text_buff), "%4.3fV", fabs(voltage));
-            } else {
-                snprintf(text_buff, sizeof(text_buff), "%4.2fV", fabs(voltage));
+                gui_page_init(page);
             }
-            gdispGFillStringBox(gui_gdisp, 2, 100, 118, 32, text_buff, gui_font, Lime, Black, justifyRight);
-
-            float current = ina219_get_current_ma() * 0.001;
-            snprintf(text_buff, sizeof(text_buff), "%4.3fA", fabs(current));
-            if (current < 0.000) {
-                gdispGFillStringBox(gui_gdisp, 120, 100, 118, 32, text_buff, gui_font, SkyBlue, Black, justifyRight);
-            } else {
-                gdispGFillStringBox(gui_gdisp, 120, 100, 118, 32, text_buff, gui_font, Orange, Black, justifyRight);
+
+            switch (page) {
+            case GUI_PAGE_IDX_GRAPH:
+                gui_page_draw_graph(sampled);
+                break;
+            case GUI_PAGE_IDX_ENERGY:
+                gui_page_draw_energy();
+                break;
+            case GUI_PAGE_IDX_STATS:
+                gui_page_draw_stats();
+                break;
+            case GUI_PAGE_IDX_INFO:
+            default:
+                gui_page_draw_info();
+                break;
+            }
+
+            gdispGBatchEnd(gui_gdisp);
+
+            GUI_PROF_END(GUI_PROF_IDX_FRAME, t0);
+
+            // the flush only ever sees complete frames, it may wait here for the SPI DMA
+            gui_flush();
+
+            if (first_frame) {
+                first_frame = false;
+
+                ESP_LOGI(TAG, "first frame: %u ms", (uint32_t)(esp_timer_get_time() / 1000));
             }
 
-            gtimerJab(&gui_flush_timer);
+#ifdef CONFIG_GUI_PROFILE
+            gui_prof_report();
+#endif
 
             vTaskDelayUntil(&xLastWakeTime, 20 / portTICK_RATE_MS);
 
             break;
+        }
         case GUI_MODE_IDX_OFF:
         default:
             gdispGSetBacklight(gui_gdisp, 0);
@@ -130,6 +667,18 @@ gui_mode_t gui_get_mode(void)
     return gui_mode;
 }
 
+void gui_set_page(gui_page_t idx)
+{
+    gui_page = idx % GUI_PAGE_IDX_MAX;
+
+    ESP_LOGI(TAG, "page: %u", gui_page);
+}
+
+gui_page_t gui_get_page(void)
+{
+    return gui_page;
+}
+
 void gui_init(void)
 {
     xTaskCreatePinnedToCore(gui_task, "guiT", 1920, NULL, 7, NULL, 1);
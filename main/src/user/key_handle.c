@@ -18,6 +18,7 @@
 #include "user/key.h"
 #include "user/led.h"
 #include "user/gui.h"
+#include "user/meter.h"
 #include "user/ble_gatts.h"
 
 #ifdef CONFIG_ENABLE_POWER_MODE_KEY
@@ -42,6 +43,10 @@ void sleep_key_handle(void)
 #endif
     fan_set_mode(FAN_MODE_IDX_OFF);
 
+#ifdef CONFIG_ENABLE_POWER_MONITOR
+    meter_env_save();
+#endif
+
 #ifdef CONFIG_ENABLE_QC
     pwr_deinit();
 #endif
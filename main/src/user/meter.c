@@ -0,0 +1,446 @@
+/*
+ * meter.c
+ *
+ *  Created on: 2020-06-02 20:15
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "core/app.h"
+#include "board/ina219.h"
+
+#include "user/fan.h"
+#include "user/meter.h"
+#include "user/ripple.h"
+
+#define TAG "meter"
+
+#define METER_POLL_MARGIN 4     // in ms, start polling this early
+#define METER_POLL_PERIOD 2     // in ms
+#define METER_RETRY_DELAY 100   // in ms
+#define METER_GAP_MAX     1000  // in ms, longer gaps between readings are not integrated
+
+#define METER_SAVE_INTERVAL 600 // in s, bounds the NVS writes to 6 per hour
+#define METER_SAVE_TIMEOUT  1000    // in ms, covers a capture or ripple window in progress
+
+#define METER_RIPPLE_INTERVAL 10000 // in ms, the other channels are not sampled during a window
+#define METER_RIPPLE_SPAN     250   // in ms, 10 cycles at 600 rpm
+#define METER_RIPPLE_LEN      1024
+
+/*
+ * The sampler fills the slot readers are not pointed at and then bumps the
+ * sequence number. A reader copies the current slot and retries if the number
+ * moved meanwhile, as the sampler may have started refilling that slot. The
+ * current slot is never being written, so neither side ever waits on the other.
+ */
+typedef struct {
+    ina219_t *dev;
+    int64_t due;            // esp_timer time of the next poll in us
+
+    meter_data_t data;      // owned by the sampler
+    int32_t cur_ua;         // the previous reading, kept exact for the integration
+    int32_t pwr_uw;
+    meter_data_t slot[2];
+    volatile uint32_t seq;
+} meter_chan_t;
+
+static meter_chan_t meter_chan[METER_CHAN_MAX] = {0};
+static uint8_t meter_chan_num = 0;
+
+static volatile bool meter_session_rst = false;
+static volatile bool meter_save_req = false;
+
+// ADC changes are handed to the sampler, it owns the bus
+static volatile bool meter_adc_set = false;
+static ina219_adc_t  meter_adc  = INA219_ADC_IDX_12BIT_128S;
+static ina219_mode_t meter_mode = INA219_MODE_IDX_CONTINUOUS;
+
+static meter_sample_t *meter_cap_buff = NULL;
+static uint16_t meter_cap_len = 0;
+static uint8_t meter_cap_chan = 0;
+static volatile bool meter_cap_busy = false;
+
+#ifdef CONFIG_ENABLE_FAN_SENSORLESS_RPM
+static int64_t meter_ripple_time = 0;
+#endif
+
+// the lifetime totals as of the last checkpoint
+static meter_total_t meter_saved[METER_CHAN_MAX] = {0};
+static int64_t meter_saved_time = 0;
+
+static void meter_publish(meter_chan_t *chan)
+{
+    chan->slot[(chan->seq + 1) & 1] = chan->data;
+
+    __sync_synchronize();
+
+    chan->seq++;
+}
+
+void meter_get_data(uint8_t idx, meter_data_t *data)
+{
+    uint32_t seq;
+
+    if (idx >= METER_CHAN_MAX) {
+        memset(data, 0x00, sizeof(meter_data_t));
+        return;
+    }
+
+    meter_chan_t *chan = &meter_chan[idx];
+
+    do {
+        seq = chan->seq;
+
+        __sync_synchronize();
+
+        *data = chan->slot[seq & 1];
+
+        __sync_synchronize();
+    } while (chan->seq != seq);
+}
+
+uint8_t meter_get_count(void)
+{
+    return meter_chan_num;
+}
+
+uint8_t meter_get_addr(uint8_t idx)
+{
+    return (idx < meter_chan_num) ? ina219_get_addr(meter_chan[idx].dev) : 0x00;
+}
+
+// rounds half away from zero, d must be positive
+static inline int64_t meter_div_round(int64_t n, int64_t d)
+{
+    return (n < 0) ? (n - d / 2) / d : (n + d / 2) / d;
+}
+
+// trapezoidal integration between the previous reading and this one
+static void meter_integrate(meter_chan_t *chan, int32_t cur_ua, int32_t pwr_uw, int64_t time)
+{
+    meter_data_t *data = &chan->data;
+    int64_t dt = time - data->time;
+
+    if (data->time != 0 && dt <= METER_GAP_MAX * 1000) {
+        // the sums are in uA*us and uW*us, halved and scaled to milli-units in one step
+        int64_t charge = meter_div_round((int64_t)(chan->cur_ua + cur_ua) * dt, 2000);
+        int64_t energy = meter_div_round((int64_t)(chan->pwr_uw + pwr_uw) * dt, 2000);
+
+        data->session.charge  += charge;
+        data->session.energy  += energy;
+        data->lifetime.charge += charge;
+        data->lifetime.energy += energy;
+    }
+
+    chan->cur_ua = cur_ua;
+    chan->pwr_uw = pwr_uw;
+
+    data->current = ina219_get_current_ma(chan->dev);
+    data->power   = ina219_get_power_mw(chan->dev);
+    data->time    = time;
+}
+
+// time from a finished conversion until the next one is worth polling for
+static int64_t meter_wait_time(meter_chan_t *chan)
+{
+    uint32_t period = ina219_get_conversion_time(chan->dev);
+
+    return (period > METER_POLL_MARGIN * 1000) ? period - METER_POLL_MARGIN * 1000 : 0;
+}
+
+static void meter_chan_update(meter_chan_t *chan, int64_t now)
+{
+    esp_err_t ret = ina219_update(chan->dev);
+
+    if (ret == ESP_OK) {
+        chan->data.voltage = ina219_get_bus_voltage_mv(chan->dev);
+
+        meter_integrate(chan, ina219_get_current_ua(chan->dev), ina219_get_power_uw(chan->dev), now);
+
+        meter_publish(chan);
+
+        // sleep through most of the next conversion, then poll for CNVR
+        chan->due = now + meter_wait_time(chan);
+    } else if (ret == ESP_ERR_INVALID_STATE) {
+        // a conversion was dropped after a range switch, the next one is as far away
+        chan->due = now + meter_wait_time(chan);
+    } else if (ret == ESP_ERR_NOT_FINISHED) {
+        chan->due = now + METER_POLL_PERIOD * 1000;
+    } else {
+        ESP_LOGE(TAG, "0x%02X: update failed: %s", ina219_get_addr(chan->dev), esp_err_to_name(ret));
+
+        chan->due = now + METER_RETRY_DELAY * 1000;
+    }
+}
+
+// read the current register back to back, at the fast ADC settings every read is a new conversion
+static void meter_capture(void)
+{
+    ina219_t *dev = meter_chan[meter_cap_chan].dev;
+    int64_t t0 = esp_timer_get_time();
+
+    for (uint16_t i = 0; i < meter_cap_len; i++) {
+        if (ina219_read_current(dev, &meter_cap_buff[i].current) != ESP_OK) {
+            ESP_LOGE(TAG, "capture aborted at %u", i);
+
+            meter_cap_len = i;
+
+            break;
+        }
+
+        meter_cap_buff[i].time = esp_timer_get_time() - t0;
+    }
+
+    ESP_LOGI(TAG, "captured %u samples from 0x%02X in %u us", meter_cap_len, ina219_get_addr(dev),
+             (uint32_t)(esp_timer_get_time() - t0));
+}
+
+#ifdef CONFIG_ENABLE_FAN_SENSORLESS_RPM
+/*
+ * Samples the fan supply current of the configured channel for its commutation
+ * ripple. The 10-bit setting gives a conversion every 296 us, fast enough for the
+ * ripple of a 4000 rpm fan while keeping 4 times the resolution of the 9-bit one.
+ */
+static void meter_ripple(void)
+{
+    // falls back to the first sensor if the configured one was not found
+    uint8_t idx = (CONFIG_FAN_RIPPLE_CHANNEL < meter_chan_num) ? CONFIG_FAN_RIPPLE_CHANNEL : 0;
+    ina219_t *dev = meter_chan[idx].dev;
+    ina219_adc_t adc = ina219_get_adc(dev);
+    ina219_mode_t mode = ina219_get_mode(dev);
+    uint16_t count = 0;
+
+    meter_sample_t *buff = malloc(METER_RIPPLE_LEN * sizeof(meter_sample_t));
+    if (!buff) {
+        return;
+    }
+
+    ina219_set_adc(dev, INA219_ADC_IDX_10BIT, INA219_MODE_IDX_CONTINUOUS);
+
+    // reads may repeat a conversion, the estimator only goes by the times
+    int64_t t0 = esp_timer_get_time();
+    while (count < METER_RIPPLE_LEN) {
+        if (ina219_read_current(dev, &buff[count].current) != ESP_OK) {
+            break;
+        }
+
+        buff[count].time = esp_timer_get_time() - t0;
+        if (buff[count++].time >= METER_RIPPLE_SPAN * 1000) {
+            break;
+        }
+    }
+
+    ina219_set_adc(dev, adc, mode);
+
+    ripple_update(buff, count);
+
+    free(buff);
+}
+#endif
+
+// only the sampler writes the checkpoint, it is the one moving the totals
+static void meter_save(void)
+{
+    bool changed = false;
+    meter_data_t data = {0};
+
+    meter_saved_time = esp_timer_get_time();
+
+    for (int i = 0; i < meter_chan_num; i++) {
+        meter_get_data(i, &data);
+
+        if (data.lifetime.charge != meter_saved[i].charge || data.lifetime.energy != meter_saved[i].energy) {
+            meter_saved[i] = data.lifetime;
+
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        app_setenv("METER_TOTAL_CFG", meter_saved, sizeof(meter_saved));
+    }
+}
+
+static void meter_task(void *pvParameter)
+{
+    meter_saved_time = esp_timer_get_time();
+
+    ESP_LOGI(TAG, "started, %u channel(s).", meter_chan_num);
+
+    // all sensors are served round-robin from this one task
+    while (1) {
+        if (meter_adc_set) {
+            meter_adc_set = false;
+
+            for (int i = 0; i < meter_chan_num; i++) {
+                ina219_set_adc(meter_chan[i].dev, meter_adc, meter_mode);
+            }
+
+            ESP_LOGI(TAG, "adc: 0x%X, mode: %u", meter_adc, meter_mode);
+        }
+
+        if (meter_session_rst) {
+            meter_session_rst = false;
+
+            for (int i = 0; i < meter_chan_num; i++) {
+                meter_chan[i].data.session.charge = 0;
+                meter_chan[i].data.session.energy = 0;
+
+                meter_publish(&meter_chan[i]);
+            }
+        }
+
+        if (meter_cap_busy) {
+            meter_capture();
+
+            __sync_synchronize();
+
+            meter_cap_busy = false;
+        }
+
+#ifdef CONFIG_ENABLE_FAN_SENSORLESS_RPM
+        // only while the fan runs without a tach signal, the first window as soon as the tach reads 0
+        if (meter_chan_num && fan_get_mode() == FAN_MODE_IDX_ON && fan_get_conf()->duty && !fan_get_tach_rpm()) {
+            if (!meter_ripple_time || esp_timer_get_time() - meter_ripple_time >= METER_RIPPLE_INTERVAL * 1000) {
+                meter_ripple_time = esp_timer_get_time();
+
+                meter_ripple();
+            }
+        } else if (meter_ripple_time) {
+            meter_ripple_time = 0;
+
+            ripple_clear();
+        }
+#endif
+
+        int64_t now = esp_timer_get_time();
+        int64_t next = now + METER_RETRY_DELAY * 1000;
+
+        for (int i = 0; i < meter_chan_num; i++) {
+            meter_chan_t *chan = &meter_chan[i];
+
+            if (chan->due <= now) {
+                meter_chan_update(chan, now);
+            }
+
+            if (chan->due < next) {
+                next = chan->due;
+            }
+        }
+
+        if (meter_save_req || now - meter_saved_time >= METER_SAVE_INTERVAL * 1000000LL) {
+            meter_save();
+
+            __sync_synchronize();
+
+            meter_save_req = false;
+        }
+
+        now = esp_timer_get_time();
+        if (next > now + 1000 * portTICK_PERIOD_MS) {
+            vTaskDelay((next - now) / 1000 / portTICK_RATE_MS);
+        } else {
+            vTaskDelay(1);
+        }
+    }
+}
+
+void meter_reset_session(void)
+{
+    meter_session_rst = true;
+
+    ESP_LOGI(TAG, "session reset.");
+}
+
+void meter_set_adc(ina219_adc_t adc, ina219_mode_t mode)
+{
+    meter_adc  = adc;
+    meter_mode = mode;
+
+    __sync_synchronize();
+
+    meter_adc_set = true;
+}
+
+esp_err_t meter_capture_start(uint8_t idx, uint16_t count)
+{
+    if (idx >= meter_chan_num) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    if (meter_cap_busy) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (count == 0 || count > METER_CAPTURE_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    free(meter_cap_buff);
+
+    meter_cap_buff = malloc(count * sizeof(meter_sample_t));
+    if (!meter_cap_buff) {
+        meter_cap_len = 0;
+
+        return ESP_ERR_NO_MEM;
+    }
+
+    meter_cap_len  = count;
+    meter_cap_chan = idx;
+
+    __sync_synchronize();
+
+    meter_cap_busy = true;
+
+    return ESP_OK;
+}
+
+const meter_sample_t *meter_capture_get(uint16_t *count)
+{
+    if (meter_cap_busy || !meter_cap_buff) {
+        return NULL;
+    }
+
+    *count = meter_cap_len;
+
+    return meter_cap_buff;
+}
+
+void meter_env_save(void)
+{
+    meter_save_req = true;
+
+    // the caller may be about to power down, so the save has to be done on return
+    for (int i = 0; meter_save_req && i < METER_SAVE_TIMEOUT / METER_POLL_PERIOD; i++) {
+        vTaskDelay(METER_POLL_PERIOD / portTICK_RATE_MS);
+    }
+
+    if (meter_save_req) {
+        ESP_LOGW(TAG, "totals not saved");
+    }
+}
+
+void meter_init(void)
+{
+    size_t length = sizeof(meter_saved);
+    app_getenv("METER_TOTAL_CFG", meter_saved, &length);
+
+    // channels follow the sensor addresses, the lowest one first
+    meter_chan_num = ina219_get_count();
+
+    for (int i = 0; i < meter_chan_num; i++) {
+        meter_chan[i].dev = ina219_get(i);
+        meter_chan[i].data.lifetime = meter_saved[i];
+        meter_chan[i].slot[0].lifetime = meter_saved[i];
+    }
+
+    xTaskCreatePinnedToCore(meter_task, "meterT", 1920, NULL, 8, NULL, 0);
+}
@@ -23,6 +23,7 @@
 #include "user/key.h"
 #include "user/led.h"
 #include "user/gui.h"
+#include "user/meter.h"
 #include "user/ble_app.h"
 #include "user/ble_gatts.h"
 
@@ -42,16 +43,24 @@
 
 #define RX_BUF_SIZE 512
 
+#define DMP_PAGE_LINES 8   // lines sent per capture dump command, so the stack never runs out of buffers
+
 #define CMD_FMT_UPD "FW+UPD:%u"
 #define CMD_FMT_RST "FW+RST!"
 #define CMD_FMT_RAM "FW+RAM?"
 #define CMD_FMT_VER "FW+VER?"
+#define CMD_FMT_CAP "PM+CAP:%u"
+#define CMD_FMT_DMP "PM+DMP:%u"
+#define CMD_FMT_CHN "PM+CHN?"
 
 enum cmd_idx {
     CMD_IDX_UPD = 0x0,
     CMD_IDX_RST = 0x1,
     CMD_IDX_RAM = 0x2,
-    CMD_IDX_VER = 0x3
+    CMD_IDX_VER = 0x3,
+    CMD_IDX_CAP = 0x4,
+    CMD_IDX_DMP = 0x5,
+    CMD_IDX_CHN = 0x6
 };
 
 typedef struct {
@@ -63,7 +72,10 @@ static const cmd_fmt_t cmd_fmt[] = {
     { .prefix = 7, .format = CMD_FMT_UPD"\r\n" },
     { .prefix = 7, .format = CMD_FMT_RST"\r\n" },
     { .prefix = 7, .format = CMD_FMT_RAM"\r\n" },
-    { .prefix = 7, .format = CMD_FMT_VER"\r\n" }
+    { .prefix = 7, .format = CMD_FMT_VER"\r\n" },
+    { .prefix = 7, .format = CMD_FMT_CAP"\r\n" },
+    { .prefix = 7, .format = CMD_FMT_DMP"\r\n" },
+    { .prefix = 7, .format = CMD_FMT_CHN"\r\n" }
 };
 
 enum rsp_idx {
@@ -280,9 +292,17 @@ void ota_exec(const char *data, uint32_t len)
             case CMD_IDX_RAM: {
                 ESP_LOGI(OTA_TAG, "GET command: "CMD_FMT_RAM);
 
-                char rsp_str[40] = {0};
-                ESP_LOGI(OTA_TAG, "free memory: %u bytes", heap_caps_get_free_size(MALLOC_CAP_DEFAULT));
-                snprintf(rsp_str, sizeof(rsp_str), "%u\r\n", heap_caps_get_free_size(MALLOC_CAP_DEFAULT));
+                char rsp_str[64] = {0};
+                size_t free_size = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+                size_t min_free_size = heap_caps_get_minimum_free_size(MALLOC_CAP_DEFAULT);
+                size_t dma_free_size = heap_caps_get_free_size(MALLOC_CAP_DMA);
+                size_t dma_largest_size = heap_caps_get_largest_free_block(MALLOC_CAP_DMA);
+                size_t spiram_free_size = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+                ESP_LOGI(OTA_TAG, "free memory: %u bytes, minimum free memory: %u bytes", free_size, min_free_size);
+                ESP_LOGI(OTA_TAG, "free dma memory: %u bytes, largest dma block: %u bytes, free spiram: %u bytes",
+                         dma_free_size, dma_largest_size, spiram_free_size);
+                snprintf(rsp_str, sizeof(rsp_str), "%u,%u,%u,%u,%u\r\n",
+                         free_size, min_free_size, dma_free_size, dma_largest_size, spiram_free_size);
 
                 ota_send_data(rsp_str, strlen(rsp_str));
 
@@ -299,6 +319,73 @@ void ota_exec(const char *data, uint32_t len)
 
                 break;
             }
+            case CMD_IDX_CAP: {
+                uint32_t count = 0, chan = 0;
+                // the channel is optional and defaults to the first sensor
+                sscanf(data, CMD_FMT_CAP",%u", &count, &chan);
+                ESP_LOGI(OTA_TAG, "GET command: "CMD_FMT_CAP",%u", count, chan);
+
+                if (count > METER_CAPTURE_MAX || chan >= METER_CHAN_MAX || meter_capture_start(chan, count) != ESP_OK) {
+                    ota_send_response(RSP_IDX_FAIL);
+                } else {
+                    ota_send_response(RSP_IDX_OK);
+                }
+
+                break;
+            }
+            case CMD_IDX_DMP: {
+                uint32_t offset = 0;
+
+                sscanf(data, CMD_FMT_DMP, &offset);
+                ESP_LOGI(OTA_TAG, "GET command: "CMD_FMT_DMP, offset);
+
+                uint16_t count = 0;
+                const meter_sample_t *samples = meter_capture_get(&count);
+                if (!samples || offset > count) {
+                    ota_send_response(RSP_IDX_FAIL);
+
+                    break;
+                }
+
+                /*
+                 * One "time_us,current_ma" line per sample, a page at a time. OK means the client
+                 * asks again from offset + DMP_PAGE_LINES, DONE ends the dump.
+                 */
+                uint32_t end = (count - offset > DMP_PAGE_LINES) ? offset + DMP_PAGE_LINES : count;
+                char line_str[32] = {0};
+                for (uint32_t i = offset; i < end; i++) {
+                    snprintf(line_str, sizeof(line_str), "%u,%.3f\r\n", samples[i].time, samples[i].current);
+
+                    ota_send_data(line_str, strlen(line_str));
+                }
+
+                if (end < count) {
+                    ota_send_response(RSP_IDX_OK);
+                } else {
+                    ota_send_response(RSP_IDX_DONE);
+                }
+
+                break;
+            }
+            case CMD_IDX_CHN: {
+                ESP_LOGI(OTA_TAG, "GET command: "CMD_FMT_CHN);
+
+                // one "idx,addr,voltage_mv,current_ma,power_mw" line per sensor
+                char line_str[48] = {0};
+                meter_data_t meter = {0};
+                for (uint8_t i = 0; i < meter_get_count(); i++) {
+                    meter_get_data(i, &meter);
+
+                    snprintf(line_str, sizeof(line_str), "%u,0x%02X,%.0f,%.3f,%.3f\r\n",
+                             i, meter_get_addr(i), meter.voltage, meter.current, meter.power);
+
+                    ota_send_data(line_str, strlen(line_str));
+                }
+
+                ota_send_response(RSP_IDX_DONE);
+
+                break;
+            }
             default:
                 ESP_LOGW(OTA_TAG, "unknown command");
 
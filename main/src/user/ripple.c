@@ -0,0 +1,128 @@
+/*
+ * ripple.c
+ *
+ *  Created on: 2020-06-12 19:05
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#include <math.h>
+#include <stdbool.h>
+
+#include "esp_log.h"
+
+#include "user/ripple.h"
+
+#define TAG "ripple"
+
+#define RIPPLE_SMOOTH     2       // samples each side in the moving average
+#define RIPPLE_HYST       0.5f    // crossing hysteresis, relative to the RMS of the ripple
+#define RIPPLE_AMP_MIN    0.5f    // in mA RMS, anything weaker is taken for noise
+#define RIPPLE_CROSS_MIN  4       // crossings needed for an estimate
+#define RIPPLE_JITTER_MAX 0.25f   // relative deviation allowed between crossing periods
+
+static volatile uint16_t ripple_rpm = 0;
+
+static float ripple_smooth(const meter_sample_t *samples, uint16_t count, uint16_t idx)
+{
+    uint16_t from = (idx > RIPPLE_SMOOTH) ? idx - RIPPLE_SMOOTH : 0;
+    uint16_t to = (idx + RIPPLE_SMOOTH < count) ? idx + RIPPLE_SMOOTH : count - 1;
+    float sum = 0.0f;
+
+    for (uint16_t i = from; i <= to; i++) {
+        sum += samples[i].current;
+    }
+
+    return sum / (to - from + 1);
+}
+
+/*
+ * Returns the ripple frequency in mHz, or 0 if there is no clear periodic ripple.
+ * Samples may be spaced unevenly and repeat a conversion, only their times count.
+ */
+uint32_t ripple_estimate(const meter_sample_t *samples, uint16_t count)
+{
+    float mean = 0.0f, rms = 0.0f;
+
+    if (count < 2 * RIPPLE_CROSS_MIN) {
+        return 0;
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        mean += samples[i].current;
+    }
+    mean /= count;
+
+    for (uint16_t i = 0; i < count; i++) {
+        float ac = ripple_smooth(samples, count, i) - mean;
+
+        rms += ac * ac;
+    }
+    rms = sqrtf(rms / count);
+
+    if (rms < RIPPLE_AMP_MIN) {
+        return 0;
+    }
+
+    // a rising crossing counts once the signal has been below -h, so noise cannot retrigger it
+    float h = RIPPLE_HYST * rms;
+    bool armed = false;
+    uint16_t cross = 0;
+    uint32_t first = 0, last = 0;
+    float period_sum = 0.0f, period_sq = 0.0f;
+
+    for (uint16_t i = 0; i < count; i++) {
+        float ac = ripple_smooth(samples, count, i) - mean;
+
+        if (ac < -h) {
+            armed = true;
+        } else if (ac > h && armed) {
+            armed = false;
+
+            if (cross++ == 0) {
+                first = samples[i].time;
+            } else {
+                float period = samples[i].time - last;
+
+                period_sum += period;
+                period_sq  += period * period;
+            }
+
+            last = samples[i].time;
+        }
+    }
+
+    if (cross < RIPPLE_CROSS_MIN || last == first) {
+        return 0;
+    }
+
+    // drift and beating show up as irregular periods
+    float period_mean = period_sum / (cross - 1);
+    float period_var = period_sq / (cross - 1) - period_mean * period_mean;
+    if (period_var > RIPPLE_JITTER_MAX * RIPPLE_JITTER_MAX * period_mean * period_mean) {
+        return 0;
+    }
+
+    return (uint64_t)(cross - 1) * 1000000000ULL / (last - first);
+}
+
+void ripple_update(const meter_sample_t *samples, uint16_t count)
+{
+#ifdef CONFIG_ENABLE_FAN_SENSORLESS_RPM
+    uint32_t freq = ripple_estimate(samples, count);
+
+    ripple_rpm = (uint64_t)freq * 60 / 1000 / CONFIG_FAN_RIPPLE_PER_REV;
+
+    ESP_LOGD(TAG, "%u samples in %u us, ripple: %u mHz, rpm: %u",
+             count, count ? samples[count - 1].time : 0, freq, ripple_rpm);
+#endif
+}
+
+void ripple_clear(void)
+{
+    ripple_rpm = 0;
+}
+
+uint16_t ripple_get_rpm(void)
+{
+    return ripple_rpm;
+}
@@ -0,0 +1,322 @@
+/*
+ * stats.c
+ *
+ *  Created on: 2020-06-09 21:40
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "esp_log.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "user/fan.h"
+#include "user/meter.h"
+#include "user/stats.h"
+
+#define TAG "stats"
+
+#define STATS_PERIOD    100     // in ms
+#define STATS_BLOCK_LEN 10      // samples per 1 s block
+#define STATS_BLOCK_MAX 60      // blocks in the longest window
+#define STATS_DEQ_LEN   60      // entries in the longest window of any level
+
+typedef enum {
+    STATS_LEVEL_IDX_SAMPLE = 0x00,
+    STATS_LEVEL_IDX_BLOCK  = 0x01,
+
+    STATS_LEVEL_IDX_MAX
+} stats_level_idx_t;
+
+// a sample, or the summary of the samples in a block
+typedef struct {
+    float min;
+    float max;
+    float mean;
+    float m2;           // sum of squared deviations from the mean
+    uint16_t n;
+} stats_entry_t;
+
+typedef struct {
+    stats_entry_t *ring;
+    uint8_t cap;        // one more than the longest window, the leaving entry is still there
+    uint32_t seq;       // entries pushed so far
+} stats_level_t;
+
+// entry sequence numbers, the low byte is enough as no window spans 256 entries
+typedef struct {
+    uint8_t seq[STATS_DEQ_LEN];
+    uint8_t head;
+    uint8_t count;
+} stats_deq_t;
+
+typedef struct {
+    stats_deq_t dmin;   // increasing minimums, the front is the window minimum
+    stats_deq_t dmax;   // decreasing maximums, the front is the window maximum
+
+    uint16_t n;
+    double mean;
+    double m2;
+} stats_win_ctx_t;
+
+typedef struct {
+    stats_entry_t samples[STATS_BLOCK_LEN + 1];
+    stats_entry_t blocks[STATS_BLOCK_MAX + 1];
+    stats_level_t level[STATS_LEVEL_IDX_MAX];
+    stats_win_ctx_t win[STATS_WIN_IDX_MAX];
+} stats_ctx_t;
+
+static const struct {
+    stats_level_idx_t level;
+    uint8_t len;        // in entries of its level
+} stats_win_cfg[STATS_WIN_IDX_MAX] = {
+    [STATS_WIN_IDX_1S]   = { STATS_LEVEL_IDX_SAMPLE, STATS_BLOCK_LEN },
+    [STATS_WIN_IDX_10S]  = { STATS_LEVEL_IDX_BLOCK,  10 },
+    [STATS_WIN_IDX_1MIN] = { STATS_LEVEL_IDX_BLOCK,  STATS_BLOCK_MAX },
+};
+
+static stats_ctx_t stats_ctx[STATS_SRC_IDX_MAX] = {0};
+
+// published the same way as the meter readings, see meter.c
+static stats_result_t stats_slot[2][STATS_SRC_IDX_MAX][STATS_WIN_IDX_MAX] = {0};
+static volatile uint32_t stats_seq = 0;
+
+static volatile stats_src_t stats_sel_src = STATS_SRC_IDX_POWER;
+static volatile stats_win_t stats_sel_win = STATS_WIN_IDX_10S;
+
+static inline stats_entry_t *stats_level_at(stats_level_t *lvl, uint32_t seq)
+{
+    return &lvl->ring[seq % lvl->cap];
+}
+
+static inline uint8_t stats_deq_at(const stats_deq_t *deq, uint8_t idx)
+{
+    return deq->seq[(deq->head + idx) % STATS_DEQ_LEN];
+}
+
+static void stats_deq_push(stats_deq_t *deq, stats_level_t *lvl, uint32_t seq, uint8_t len, bool max)
+{
+    float val = max ? stats_level_at(lvl, seq)->max : stats_level_at(lvl, seq)->min;
+
+    // entries that can never be the extreme again go out at the back
+    while (deq->count) {
+        uint8_t age = (uint8_t)seq - stats_deq_at(deq, deq->count - 1);
+        const stats_entry_t *back = stats_level_at(lvl, seq - age);
+
+        if (max ? (back->max > val) : (back->min < val)) {
+            break;
+        }
+
+        deq->count--;
+    }
+
+    deq->seq[(deq->head + deq->count++) % STATS_DEQ_LEN] = seq;
+
+    // and the ones that left the window at the front
+    while ((uint8_t)((uint8_t)seq - stats_deq_at(deq, 0)) >= len) {
+        deq->head = (deq->head + 1) % STATS_DEQ_LEN;
+        deq->count--;
+    }
+}
+
+static const stats_entry_t *stats_deq_front(const stats_deq_t *deq, stats_level_t *lvl)
+{
+    uint8_t age = (uint8_t)(lvl->seq - 1) - stats_deq_at(deq, 0);
+
+    return stats_level_at(lvl, lvl->seq - 1 - age);
+}
+
+// Chan's pairwise update, merges an entry into the window
+static void stats_win_add(stats_win_ctx_t *w, const stats_entry_t *e)
+{
+    uint16_t n = w->n + e->n;
+    double delta = e->mean - w->mean;
+
+    w->m2  += e->m2 + delta * delta * w->n * e->n / n;
+    w->mean += delta * e->n / n;
+    w->n    = n;
+}
+
+// the same update run backwards, takes an entry out of the window
+static void stats_win_del(stats_win_ctx_t *w, const stats_entry_t *e)
+{
+    uint16_t n = w->n - e->n;
+
+    if (n == 0) {
+        w->n    = 0;
+        w->mean = 0.0;
+        w->m2   = 0.0;
+        return;
+    }
+
+    double mean  = (w->mean * w->n - (double)e->mean * e->n) / n;
+    double delta = e->mean - mean;
+
+    w->m2  -= e->m2 + delta * delta * n * e->n / w->n;
+    w->mean = mean;
+    w->n    = n;
+
+    if (w->m2 < 0.0) {
+        w->m2 = 0.0;
+    }
+}
+
+static void stats_win_push(stats_win_ctx_t *w, stats_level_t *lvl, uint8_t len)
+{
+    uint32_t seq = lvl->seq - 1;
+
+    stats_win_add(w, stats_level_at(lvl, seq));
+    if (seq >= len) {
+        stats_win_del(w, stats_level_at(lvl, seq - len));
+    }
+
+    // rounding piles up across the add/del pairs, start over from the entries once per window
+    if ((seq + 1) % len == 0) {
+        w->n    = 0;
+        w->mean = 0.0;
+        w->m2   = 0.0;
+
+        for (uint32_t i = seq + 1 - len; i <= seq; i++) {
+            stats_win_add(w, stats_level_at(lvl, i));
+        }
+    }
+
+    stats_deq_push(&w->dmin, lvl, seq, len, false);
+    stats_deq_push(&w->dmax, lvl, seq, len, true);
+}
+
+static void stats_level_push(stats_ctx_t *ctx, stats_level_idx_t idx, const stats_entry_t *e)
+{
+    stats_level_t *lvl = &ctx->level[idx];
+
+    *stats_level_at(lvl, lvl->seq++) = *e;
+
+    for (int i = 0; i < STATS_WIN_IDX_MAX; i++) {
+        if (stats_win_cfg[i].level == idx) {
+            stats_win_push(&ctx->win[i], lvl, stats_win_cfg[i].len);
+        }
+    }
+}
+
+static void stats_result(stats_ctx_t *ctx, stats_win_t idx, stats_result_t *res)
+{
+    stats_win_ctx_t *w = &ctx->win[idx];
+    stats_level_t *lvl = &ctx->level[stats_win_cfg[idx].level];
+
+    if (w->n == 0) {
+        memset(res, 0x00, sizeof(stats_result_t));
+        return;
+    }
+
+    res->min   = stats_deq_front(&w->dmin, lvl)->min;
+    res->max   = stats_deq_front(&w->dmax, lvl)->max;
+    res->mean  = w->mean;
+    res->std   = sqrt(w->m2 / w->n);
+    res->count = w->n;
+}
+
+static void stats_update(stats_ctx_t *ctx, float val)
+{
+    stats_entry_t e = { val, val, val, 0.0f, 1 };
+
+    stats_level_push(ctx, STATS_LEVEL_IDX_SAMPLE, &e);
+
+    // a full 1 s window is exactly the block that just ended
+    if (ctx->level[STATS_LEVEL_IDX_SAMPLE].seq % STATS_BLOCK_LEN == 0) {
+        stats_result_t res = {0};
+        stats_result(ctx, STATS_WIN_IDX_1S, &res);
+
+        e.min  = res.min;
+        e.max  = res.max;
+        e.mean = ctx->win[STATS_WIN_IDX_1S].mean;
+        e.m2   = ctx->win[STATS_WIN_IDX_1S].m2;
+        e.n    = ctx->win[STATS_WIN_IDX_1S].n;
+
+        stats_level_push(ctx, STATS_LEVEL_IDX_BLOCK, &e);
+    }
+}
+
+static void stats_publish(void)
+{
+    uint32_t slot = (stats_seq + 1) & 1;
+
+    for (int i = 0; i < STATS_SRC_IDX_MAX; i++) {
+        for (int j = 0; j < STATS_WIN_IDX_MAX; j++) {
+            stats_result(&stats_ctx[i], j, &stats_slot[slot][i][j]);
+        }
+    }
+
+    __sync_synchronize();
+
+    stats_seq++;
+}
+
+static void stats_task(void *pvParameter)
+{
+    portTickType xLastWakeTime = xTaskGetTickCount();
+
+    ESP_LOGI(TAG, "started.");
+
+    while (1) {
+        meter_data_t meter = {0};
+        meter_get_data(0, &meter);
+
+        stats_update(&stats_ctx[STATS_SRC_IDX_VOLTAGE], meter.voltage);
+        stats_update(&stats_ctx[STATS_SRC_IDX_CURRENT], meter.current);
+        stats_update(&stats_ctx[STATS_SRC_IDX_POWER],   meter.power);
+        stats_update(&stats_ctx[STATS_SRC_IDX_RPM],     fan_get_rpm());
+
+        stats_publish();
+
+        vTaskDelayUntil(&xLastWakeTime, STATS_PERIOD / portTICK_RATE_MS);
+    }
+}
+
+void stats_get(stats_src_t src, stats_win_t win, stats_result_t *res)
+{
+    uint32_t seq;
+
+    if (src >= STATS_SRC_IDX_MAX || win >= STATS_WIN_IDX_MAX) {
+        memset(res, 0x00, sizeof(stats_result_t));
+        return;
+    }
+
+    do {
+        seq = stats_seq;
+
+        __sync_synchronize();
+
+        *res = stats_slot[seq & 1][src][win];
+
+        __sync_synchronize();
+    } while (stats_seq != seq);
+}
+
+void stats_set_sel(stats_src_t src, stats_win_t win)
+{
+    stats_sel_src = src % STATS_SRC_IDX_MAX;
+    stats_sel_win = win % STATS_WIN_IDX_MAX;
+
+    ESP_LOGI(TAG, "selected: src: %u, win: %u", stats_sel_src, stats_sel_win);
+}
+
+void stats_get_sel(stats_src_t *src, stats_win_t *win)
+{
+    *src = stats_sel_src;
+    *win = stats_sel_win;
+}
+
+void stats_init(void)
+{
+    for (int i = 0; i < STATS_SRC_IDX_MAX; i++) {
+        stats_ctx[i].level[STATS_LEVEL_IDX_SAMPLE].ring = stats_ctx[i].samples;
+        stats_ctx[i].level[STATS_LEVEL_IDX_SAMPLE].cap  = STATS_BLOCK_LEN + 1;
+        stats_ctx[i].level[STATS_LEVEL_IDX_BLOCK].ring  = stats_ctx[i].blocks;
+        stats_ctx[i].level[STATS_LEVEL_IDX_BLOCK].cap   = STATS_BLOCK_MAX + 1;
+    }
+
+    xTaskCreatePinnedToCore(stats_task, "statsT", 1920, NULL, 6, NULL, 0);
+}
@@ -0,0 +1,553 @@
+/*
+ * bench.c
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "freertos/task.h"
+
+#include "board/st7789.h"
+
+#include "st7789_host.h"
+
+// the frame under test is the one gui_task draws, its statics are reached through the source
+#define CONFIG_GUI_PROFILE 1
+#define CONFIG_GUI_PROFILE_INTERVAL 1
+#include "../../main/src/user/gui.c"
+
+#ifdef HOST_GDISP_BASELINE
+#include "src/gdisp/gdisp_driver.h"
+
+#define BENCH_BUILD "baseline"
+#else
+#define BENCH_BUILD "target"
+#endif
+
+#define BENCH_FRAMES 2000
+
+typedef struct {
+    const char *name;
+    void (*run)(uint32_t n);
+} bench_section_t;
+
+/*
+ * The state the pages show. The readings wander a little every frame like a live INA219 and
+ * tach do, so the value fields are redrawn the way they are on the device.
+ */
+static uint32_t bench_tick = 0;
+
+static fan_conf_t bench_fan_conf = { .duty = 128 };
+
+uint16_t fan_get_rpm(void)
+{
+    return 1800 + (bench_tick * 7) % 50;
+}
+
+fan_conf_t *fan_get_conf(void)
+{
+    return &bench_fan_conf;
+}
+
+bool fan_env_saved(void)
+{
+    return true;
+}
+
+char *pwr_get_mode_str(void)
+{
+    return "QC 12V";
+}
+
+bool pwr_env_saved(void)
+{
+    return true;
+}
+
+void meter_get_data(uint8_t idx, meter_data_t *data)
+{
+    memset(data, 0x00, sizeof(meter_data_t));
+
+    data->voltage = 12034.0f + (bench_tick * 13) % 29;
+    data->current = 420.0f + (bench_tick * 11) % 37;
+    data->power   = data->voltage * data->current / 1000.0f;
+
+    data->session.charge  = (int64_t)bench_tick * 420 * 20000;
+    data->session.energy  = (int64_t)bench_tick * 5054 * 20000;
+    data->lifetime.charge = data->session.charge + 1234LL * METER_US_PER_HOUR;
+    data->lifetime.energy = data->session.energy + 14808LL * METER_US_PER_HOUR;
+}
+
+void stats_get_sel(stats_src_t *src, stats_win_t *win)
+{
+    *src = STATS_SRC_IDX_POWER;
+    *win = STATS_WIN_IDX_10S;
+}
+
+void stats_get(stats_src_t src, stats_win_t win, stats_result_t *res)
+{
+    res->min   = 5010.0f;
+    res->max   = 5120.0f + bench_tick % 17;
+    res->mean  = 5064.0f + (bench_tick * 3) % 11;
+    res->std   = 21.0f + bench_tick % 5;
+    res->count = 100;
+}
+
+static uint64_t bench_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// FNV-1a over the panel, to tell whether two builds drew the same picture
+static uint32_t bench_gram_hash(void)
+{
+    const uint8_t *gram = st7789_host_get_gram();
+    uint32_t hash = 2166136261u;
+
+    for (uint32_t i = 0; i < ST7789_SCREEN_WIDTH * ST7789_SCREEN_HEIGHT * 2; i++) {
+        hash = (hash ^ gram[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+static void bench_report(const char *what, uint32_t calls, uint64_t ns, uint32_t ops)
+{
+    printf("  %-28s %8u calls  %10.3f us/call", what, calls, calls ? ns / 1000.0 / calls : 0.0);
+    if (ops) {
+        printf("  %12.0f /s", ns ? ops * 1e9 / ns : 0.0);
+    }
+    printf("\n");
+}
+
+static void bench_gui_page(gui_page_t page, uint32_t n)
+{
+    static const char *page_str[GUI_PAGE_IDX_MAX] = {
+        [GUI_PAGE_IDX_INFO]   = "info",
+        [GUI_PAGE_IDX_GRAPH]  = "graph",
+        [GUI_PAGE_IDX_ENERGY] = "energy",
+        [GUI_PAGE_IDX_STATS]  = "stats",
+    };
+    uint64_t frame_sum = 0, frame_max = 0;
+    uint8_t frame_cnt = 0;
+    st7789_host_stat_t stat = {0};
+
+    gdispGBatchBegin(gui_gdisp);
+    gui_page_init(page);
+    gdispGBatchEnd(gui_gdisp);
+    gui_flush();
+
+    memset(gui_prof, 0x00, sizeof(gui_prof));
+    gui_prof_bytes = 0;
+    st7789_host_clr_stat();
+
+    // one gui_task iteration per frame, flush included
+    for (uint32_t i = 0; i < n; i++, bench_tick++) {
+        uint64_t t0 = bench_ns();
+
+        bool sampled = false;
+        if (++frame_cnt == GUI_GRAPH_PERIOD) {
+            frame_cnt = 0;
+
+            gui_hist_push();
+
+            sampled = true;
+        }
+
+        gdispGBatchBegin(gui_gdisp);
+
+        switch (page) {
+        case GUI_PAGE_IDX_GRAPH:
+            gui_page_draw_graph(sampled);
+            break;
+        case GUI_PAGE_IDX_ENERGY:
+            gui_page_draw_energy();
+            break;
+        case GUI_PAGE_IDX_STATS:
+            gui_page_draw_stats();
+            break;
+        case GUI_PAGE_IDX_INFO:
+        default:
+            gui_page_draw_info();
+            break;
+        }
+
+        gdispGBatchEnd(gui_gdisp);
+
+        gui_flush();
+
+        uint64_t t = bench_ns() - t0;
+        frame_sum += t;
+        if (t > frame_max) {
+            frame_max = t;
+        }
+    }
+
+    st7789_host_get_stat(&stat);
+
+    printf("page %s: %u frames, %.1f frames/s, %llu bytes flushed/frame, %u bytes/frame drawn, gram %08x\n",
+           page_str[page], n, frame_sum ? n * 1e9 / frame_sum : 0.0,
+           (unsigned long long)(n ? stat.bytes / n : 0), n ? gui_prof_bytes / n : 0, bench_gram_hash());
+    printf("  %-28s %8u calls  %10.3f us/call  max %u us\n", "frame", n,
+           n ? frame_sum / 1000.0 / n : 0.0, (uint32_t)(frame_max / 1000));
+    for (int i = GUI_PROF_IDX_FIELD; i < GUI_PROF_IDX_MAX; i++) {
+        printf("  %-28s %8u calls  %10.3f us/call  max %u us\n", gui_prof_str[i], gui_prof[i].cnt,
+               gui_prof[i].cnt ? (double)gui_prof[i].sum / gui_prof[i].cnt : 0.0, gui_prof[i].max);
+    }
+}
+
+static void bench_gui(uint32_t n)
+{
+    for (int i = 0; i < GUI_PAGE_IDX_MAX; i++) {
+        bench_gui_page(i, n);
+    }
+}
+
+// the primitives a value field is made of, one at a time
+static void bench_prim(uint32_t n)
+{
+    char text_buff[32] = {0};
+    uint64_t t0 = 0, t = 0;
+
+    printf("primitives:\n");
+
+    t0 = bench_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        gui_fmt_str(gui_fmt_fixed(text_buff, 12000 + i % 1000, 3), "V");
+        gdispGFillStringBox(gui_gdisp, 2, 100, 118, GUI_FIELD_HEIGHT, text_buff, gui_font, Lime, Black, justifyRight);
+    }
+    t = bench_ns() - t0;
+    bench_report("fill string box", n, t, 0);
+
+    if (gui_field_pixmap) {
+        t0 = bench_ns();
+        for (uint32_t i = 0; i < n; i++) {
+            gui_fmt_str(gui_fmt_fixed(text_buff, 12000 + i % 1000, 3), "V");
+            gdispGFillStringBox(gui_field_pixmap, 0, 0, 118, GUI_FIELD_HEIGHT, text_buff, gui_font, Lime, Black, justifyRight);
+        }
+        t = bench_ns() - t0;
+        bench_report("fill string box, pixmap", n, t, 0);
+
+        t0 = bench_ns();
+        for (uint32_t i = 0; i < n; i++) {
+            gdispGBlitArea(gui_gdisp, 2, 100, 118, GUI_FIELD_HEIGHT, 0, 0, GUI_FIELD_WIDTH, gdispPixmapGetBits(gui_field_pixmap));
+        }
+        t = bench_ns() - t0;
+        bench_report("blit field", n, t, 0);
+    }
+
+    t0 = bench_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        gdispGFillArea(gui_gdisp, 0, 0, gdispGGetWidth(gui_gdisp), gdispGGetHeight(gui_gdisp), i & 1 ? Black : Blue);
+    }
+    t = bench_ns() - t0;
+    bench_report("fill screen", n, t, 0);
+
+    t0 = bench_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        gdispGDrawLine(gui_gdisp, GUI_GRAPH_X + i % GUI_GRAPH_WIDTH, 0, GUI_GRAPH_X + i % GUI_GRAPH_WIDTH, 44, Yellow);
+    }
+    t = bench_ns() - t0;
+    bench_report("vertical line", n, t, 0);
+
+    t0 = bench_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        gdispGFillArea(gui_gdisp, 0, 0, 1, 1, Black);
+        gui_flush();
+    }
+    t = bench_ns() - t0;
+    bench_report("flush", n, t, 0);
+}
+
+// filled text straight on the display, the spans go to the driver's fill or through the stream calls
+static void bench_text(uint32_t n)
+{
+    static const char *font_str[] = { "DejaVuSans32", "DejaVuSans32_aa", "DejaVuSans12" };
+    static const char *text_str[] = { "12.034V", "1800RPM", "QC 12V" };
+    printf("fill string box:\n");
+
+    for (int i = 0; i < sizeof(font_str) / sizeof(font_str[0]); i++) {
+        font_t font = gdispOpenFont(font_str[i]);
+        coord_t cy = gdispGetFontMetric(font, fontHeight);
+        uint64_t t0 = bench_ns();
+
+        for (uint32_t j = 0; j < n; j++) {
+            gdispGFillStringBox(gui_gdisp, 0, (j % 4) * cy, 180, cy, text_str[j % 3], font,
+                                j & 1 ? Lime : Cyan, Black, justifyRight);
+        }
+
+        uint64_t t = bench_ns() - t0;
+        bench_report(font_str[i], n, t, n);
+
+        gdispCloseFont(font);
+    }
+
+    gui_flush();
+}
+
+// what right-justified fields ask the font for every frame
+static void bench_width(uint32_t n)
+{
+    static const char *font_str[] = { "DejaVuSans32_aa", "DejaVuSans12" };
+    char text_buff[32] = {0};
+    volatile coord_t width = 0;
+
+    printf("string width:\n");
+
+    for (int i = 0; i < sizeof(font_str) / sizeof(font_str[0]); i++) {
+        font_t font = gdispOpenFont(font_str[i]);
+        char name[48] = {0};
+        uint64_t t0 = 0, t = 0;
+
+        t0 = bench_ns();
+        for (uint32_t j = 0; j < n; j++) {
+            width = gdispGetStringWidth("12.034V", font);
+        }
+        t = bench_ns() - t0;
+        snprintf(name, sizeof(name), "%s, same", font_str[i]);
+        bench_report(name, n, t, n);
+
+        t0 = bench_ns();
+        for (uint32_t j = 0; j < n; j++) {
+            gui_fmt_str(gui_fmt_fixed(text_buff, 12000 + j % 1000, 3), "V");
+            width = gdispGetStringWidth(text_buff, font);
+        }
+        t = bench_ns() - t0;
+        snprintf(name, sizeof(name), "%s, changing", font_str[i]);
+        bench_report(name, n, t, n);
+
+        t0 = bench_ns();
+        for (uint32_t j = 0; j < n; j++) {
+            width = gdispGetCharWidth('0' + j % 10, font);
+        }
+        t = bench_ns() - t0;
+        snprintf(name, sizeof(name), "%s, char", font_str[i]);
+        bench_report(name, n, t, n);
+
+        gdispCloseFont(font);
+    }
+
+    (void)width;
+}
+
+// a full screen 24-bit BMP, bottom-up rows like most tools write them
+static int bench_image_write(const char *path, uint16_t w, uint16_t h)
+{
+    uint32_t row = (w * 3 + 3) & ~3;
+    uint32_t size = 54 + row * h;
+    uint8_t head[54] = {
+        'B', 'M', size, size >> 8, size >> 16, size >> 24, 0, 0, 0, 0, 54, 0, 0, 0,
+        40, 0, 0, 0, w, w >> 8, 0, 0, h, h >> 8, 0, 0, 1, 0, 24, 0,
+    };
+    uint8_t line[row];
+    FILE *f = fopen(path, "wb");
+
+    if (!f) {
+        return -1;
+    }
+
+    fwrite(head, 1, sizeof(head), f);
+    for (int y = h - 1; y >= 0; y--) {
+        memset(line, 0x00, row);
+        for (int x = 0; x < w; x++) {
+            line[x * 3 + 0] = x * 255 / w;
+            line[x * 3 + 1] = y * 255 / h;
+            line[x * 3 + 2] = (x ^ y) & 0xFF;
+        }
+        fwrite(line, 1, row, f);
+    }
+    fclose(f);
+
+    return 0;
+}
+
+static void bench_image(uint32_t n)
+{
+    char path[] = "/tmp/gui_bench_XXXXXX";
+    coord_t w = gdispGGetWidth(gui_gdisp), h = gdispGGetHeight(gui_gdisp);
+    gdispImage img;
+    gdispImage *cached = NULL;
+    uint64_t t0 = 0, t = 0;
+
+    int fd = mkstemp(path);
+    if (fd < 0 || bench_image_write(path, w, h) != 0) {
+        fprintf(stderr, "image: cannot write %s\n", path);
+        return;
+    }
+    close(fd);
+
+    printf("image %ux%u bmp:\n", w, h);
+
+    t0 = bench_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        gdispImageOpenFile(&img, path);
+        gdispGImageDraw(gui_gdisp, &img, 0, 0, w, h, 0, 0);
+        gdispImageClose(&img);
+    }
+    t = bench_ns() - t0;
+    bench_report("open, decode, draw", n, t, n);
+
+    gdispImageOpenFile(&img, path);
+    t0 = bench_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        gdispGImageDraw(gui_gdisp, &img, 0, 0, w, h, 0, 0);
+    }
+    t = bench_ns() - t0;
+    gdispImageClose(&img);
+    bench_report("decode, draw", n, t, n);
+
+    t0 = bench_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        cached = gdispImageCacheOpen(path);
+        if (cached) {
+            gdispGImageDraw(gui_gdisp, cached, 0, 0, w, h, 0, 0);
+        }
+    }
+    t = bench_ns() - t0;
+    bench_report("file cache, draw", n, t, n);
+
+    gdispImageCacheFlush();
+    gui_flush();
+
+    printf("  gram %08x\n", bench_gram_hash());
+
+    unlink(path);
+}
+
+// the voltage field three ways, each value is a reading in mV
+static void bench_fmt(uint32_t n)
+{
+    char text_buff[32] = {0}, ref_buff[32] = {0};
+    uint64_t t0 = 0, t = 0;
+    volatile char sink = 0;
+
+    printf("format voltage:\n");
+
+    // the formatter has to write what printf would
+    for (uint32_t i = 0; i < 100000; i++) {
+        for (uint8_t frac = 0; frac <= 3; frac++) {
+            static const uint32_t scale[] = { 1, 10, 100, 1000 };
+
+            gui_fmt_fixed(text_buff, i, frac);
+            if (frac) {
+                snprintf(ref_buff, sizeof(ref_buff), "%u.%0*u", i / scale[frac], frac, i % scale[frac]);
+            } else {
+                snprintf(ref_buff, sizeof(ref_buff), "%u", i);
+            }
+            if (strcmp(text_buff, ref_buff) != 0) {
+                fprintf(stderr, "format: %u with %u decimals gives \"%s\", expected \"%s\"\n", i, frac, text_buff, ref_buff);
+                exit(1);
+            }
+        }
+    }
+
+    t0 = bench_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        float voltage = (5000 + i % 10000) * 0.001f;
+        if (voltage < 10.00) {
+            snprintf(text_buff, sizeof(text_buff), "%4.3fV", fabs(voltage));
+        } else {
+            snprintf(text_buff, sizeof(text_buff), "%4.2fV", fabs(voltage));
+        }
+        sink = text_buff[3];
+    }
+    t = bench_ns() - t0;
+    bench_report("snprintf %f", n, t, n);
+
+    t0 = bench_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t voltage = 5000 + i % 10000;
+        if (voltage < 10000) {
+            snprintf(text_buff, sizeof(text_buff), "%u.%03uV", voltage / 1000, voltage % 1000);
+        } else {
+            voltage = (voltage + 5) / 10;
+            snprintf(text_buff, sizeof(text_buff), "%u.%02uV", voltage / 100, voltage % 100);
+        }
+        sink = text_buff[3];
+    }
+    t = bench_ns() - t0;
+    bench_report("snprintf %u", n, t, n);
+
+    t0 = bench_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t voltage = 5000 + i % 10000;
+        if (voltage < 10000) {
+            gui_fmt_str(gui_fmt_fixed(text_buff, voltage, 3), "V");
+        } else {
+            gui_fmt_str(gui_fmt_fixed(text_buff, (voltage + 5) / 10, 2), "V");
+        }
+        sink = text_buff[3];
+    }
+    t = bench_ns() - t0;
+    bench_report("gui_fmt_fixed", n, t, n);
+
+    (void)sink;
+}
+
+static const bench_section_t bench_section[] = {
+    { "gui",   bench_gui   },
+    { "prim",  bench_prim  },
+    { "text",  bench_text  },
+    { "width", bench_width },
+    { "image", bench_image },
+    { "fmt",   bench_fmt   },
+};
+
+static void bench_init(void)
+{
+    gfxInit();
+
+    gui_gdisp = gdispGetDisplay(0);
+    gui_font = gdispOpenFont("DejaVuSans32_aa");
+    gui_font_small = gdispOpenFont("DejaVuSans12");
+
+    gui_field_pixmap = gdispPixmapCreate(GUI_FIELD_WIDTH, GUI_FIELD_HEIGHT);
+
+#ifdef HOST_GDISP_BASELINE
+    // a driver without fill and blit, every span and image row goes through the stream calls
+    static GDISPVMT vmt;
+
+    vmt = *gvmt(gui_gdisp);
+    vmt.fill = NULL;
+    vmt.blit = NULL;
+    gui_gdisp->d.vmt = (const GDriverVMT *)&vmt;
+#endif
+
+    gdispGSetOrientation(gui_gdisp, CONFIG_LCD_ROTATION_DEGREE);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *name = (argc > 1) ? argv[1] : "all";
+    uint32_t n = (argc > 2) ? strtoul(argv[2], NULL, 0) : BENCH_FRAMES;
+    bool found = false;
+
+    bench_init();
+
+    printf("build: %s, %ux%u, %u iterations\n", BENCH_BUILD,
+           gdispGGetWidth(gui_gdisp), gdispGGetHeight(gui_gdisp), n);
+
+    for (int i = 0; i < sizeof(bench_section) / sizeof(bench_section[0]); i++) {
+        if (strcmp(name, "all") == 0 || strcmp(name, bench_section[i].name) == 0) {
+            bench_section[i].run(n);
+            found = true;
+        }
+    }
+
+    if (!found) {
+        fprintf(stderr, "usage: %s [all|gui|prim|text|width|image|fmt] [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * esp_host.c
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#include <time.h>
+
+#include "esp_timer.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+
+/*
+ * Only the time base does real work. The task and event group calls are linked in with the
+ * firmware sources but nothing on the host runs them, the benchmarks call the code directly.
+ */
+
+EventGroupHandle_t user_event_group = NULL;
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *name, uint32_t stack, void *param,
+                                   UBaseType_t prio, TaskHandle_t *handle, BaseType_t core)
+{
+    return pdFALSE;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+void vTaskDelayUntil(TickType_t *prev, TickType_t inc)
+{
+    *prev += inc;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    return bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear,
+                                BaseType_t all, TickType_t wait)
+{
+    return bits;
+}
@@ -0,0 +1,49 @@
+/*
+ * gfxconf_host.h
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#ifndef _GFXCONF_HOST_H
+#define _GFXCONF_HOST_H
+
+/*
+ * Forced in front of every host source. It takes the target gfxconf.h as it is and only
+ * swaps what cannot run on Linux, so the µGFX code measured here is built like on the ESP32.
+ */
+#include "../../components/ugfx/gfxconf.h"
+
+#undef GFX_USE_OS_FREERTOS
+#define GFX_USE_OS_LINUX                             TRUE
+
+/*
+ * On the ESP32 port gfxSystemLock() takes the spinlock of the caller, the Linux port has one
+ * global lock and no argument.
+ */
+typedef int portMUX_TYPE __attribute__((unused));
+#define portMUX_INITIALIZER_UNLOCKED                 0
+#define gfxSystemLock(mux)                           gfxSystemLock()
+#define gfxSystemUnlock(mux)                         gfxSystemUnlock()
+
+#undef GFILE_NEED_MMAPFS
+#define GFILE_NEED_MMAPFS                            FALSE
+#define GFILE_NEED_NATIVEFS                          TRUE
+
+#define GDISP_INCLUDE_FONT_DEJAVUSANS32              TRUE
+
+/*
+ * The baseline build leaves out the rendering work that can be switched off at compile time:
+ * text spans and image rows go through the stream calls, and string widths are not cached.
+ * The driver is shared with the normal build, the benchmark drops its fill and blit at run time.
+ */
+#ifdef HOST_GDISP_BASELINE
+    #undef GDISP_HARDWARE_FILLS
+    #define GDISP_HARDWARE_FILLS                     HARDWARE_AUTODETECT
+    #undef GDISP_HARDWARE_BITFILLS
+    #define GDISP_HARDWARE_BITFILLS                  HARDWARE_AUTODETECT
+    #undef GDISP_NEED_TEXT_WIDTHCACHE
+    #define GDISP_NEED_TEXT_WIDTHCACHE               FALSE
+#endif
+
+#endif /* _GFXCONF_HOST_H */
@@ -0,0 +1,17 @@
+# Runs both benchmark builds and checks that every page and image ends up with the same picture.
+#
+#   cmake -DBENCH=<gui_bench> -DBASELINE=<gui_bench_baseline> -P gram_cmp.cmake
+
+foreach(exe BENCH BASELINE)
+    execute_process(COMMAND ${${exe}} all 30 OUTPUT_VARIABLE out RESULT_VARIABLE ret)
+    if(NOT ret EQUAL 0)
+        message(FATAL_ERROR "${${exe}} failed: ${ret}")
+    endif()
+    string(REGEX MATCHALL "gram [0-9a-f]+" ${exe}_GRAM "${out}")
+endforeach()
+
+if(NOT BENCH_GRAM STREQUAL BASELINE_GRAM)
+    message(FATAL_ERROR "pictures differ\n  ${BENCH_GRAM}\n  ${BASELINE_GRAM}")
+endif()
+
+message(STATUS "same pictures: ${BENCH_GRAM}")
@@ -0,0 +1,17 @@
+/*
+ * i2c_host.h
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#ifndef _I2C_HOST_H
+#define _I2C_HOST_H
+
+#include <stdint.h>
+
+// the register file of the one device on the host bus
+extern void i2c_host_set_reg(uint8_t addr, uint8_t reg, uint16_t val);
+extern uint16_t i2c_host_get_reg(uint8_t addr, uint8_t reg);
+
+#endif /* _I2C_HOST_H */
@@ -0,0 +1,18 @@
+/*
+ * sdkconfig.h
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#ifndef _SDKCONFIG_HOST_H
+#define _SDKCONFIG_HOST_H
+
+// the parts of the default configuration the host build compiles
+
+#define CONFIG_ENABLE_GUI 1
+#define CONFIG_LCD_ORIENTATION_NORMAL 1
+#define CONFIG_LCD_ROTATION_DEGREE 90
+#define CONFIG_LCD_RENDER_MODE_FRAMEBUFFER 1
+
+#endif /* _SDKCONFIG_HOST_H */
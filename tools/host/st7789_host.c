@@ -0,0 +1,80 @@
+/*
+ * st7789_host.c
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#include <string.h>
+
+#include "board/st7789.h"
+
+#include "st7789_host.h"
+
+/*
+ * The board side of the ST7789 driver with the panel in memory. The driver itself is the
+ * target one, so the framebuffer layout, byte order and orientation maths are the same;
+ * a GRAM refresh copies the frame where the SPI DMA would send it.
+ */
+
+static uint8_t st7789_gram[ST7789_SCREEN_WIDTH * ST7789_SCREEN_HEIGHT * 2] = {0};
+
+static st7789_host_stat_t st7789_stat = {0};
+
+void st7789_init_board(void) {}
+
+void st7789_set_backlight(uint8_t val) {}
+
+void st7789_setpin_dc(spi_transaction_t *t) {}
+
+void st7789_setpin_reset(uint8_t val) {}
+
+void st7789_write_cmd(uint8_t cmd)
+{
+    st7789_stat.cmds++;
+}
+
+void st7789_write_data(uint8_t data)
+{
+    st7789_stat.bytes++;
+}
+
+void st7789_write_cmd_data(uint8_t cmd, const uint8_t *data, uint32_t n)
+{
+    st7789_stat.cmds++;
+    st7789_stat.bytes += n;
+}
+
+void st7789_write_buff(uint8_t *buff, uint32_t n)
+{
+    st7789_stat.bytes += n;
+}
+
+void st7789_write_strip(uint8_t *buff, uint32_t n)
+{
+    st7789_stat.bytes += n;
+}
+
+void st7789_refresh_gram(uint8_t *gram)
+{
+    memcpy(st7789_gram, gram, sizeof(st7789_gram));
+
+    st7789_stat.cmds++;
+    st7789_stat.bytes += sizeof(st7789_gram);
+    st7789_stat.refreshes++;
+}
+
+const uint8_t *st7789_host_get_gram(void)
+{
+    return st7789_gram;
+}
+
+void st7789_host_get_stat(st7789_host_stat_t *stat)
+{
+    *stat = st7789_stat;
+}
+
+void st7789_host_clr_stat(void)
+{
+    memset(&st7789_stat, 0x00, sizeof(st7789_stat));
+}
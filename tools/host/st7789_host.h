@@ -0,0 +1,24 @@
+/*
+ * st7789_host.h
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#ifndef _ST7789_HOST_H
+#define _ST7789_HOST_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint32_t cmds;          // command bytes
+    uint64_t bytes;         // data bytes, what the SPI bus would carry after the commands
+    uint32_t refreshes;     // full GRAM transfers
+} st7789_host_stat_t;
+
+extern const uint8_t *st7789_host_get_gram(void);
+
+extern void st7789_host_get_stat(st7789_host_stat_t *stat);
+extern void st7789_host_clr_stat(void);
+
+#endif /* _ST7789_HOST_H */
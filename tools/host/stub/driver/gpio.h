@@ -0,0 +1,13 @@
+/*
+ * gpio.h
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#ifndef _DRIVER_GPIO_HOST_H
+#define _DRIVER_GPIO_HOST_H
+
+#include "esp_err.h"
+
+#endif /* _DRIVER_GPIO_HOST_H */
@@ -0,0 +1,21 @@
+/*
+ * i2c.h
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#ifndef _DRIVER_I2C_HOST_H
+#define _DRIVER_I2C_HOST_H
+
+#include "esp_err.h"
+
+typedef enum {
+    I2C_NUM_0 = 0,
+    I2C_NUM_1,
+    I2C_NUM_MAX
+} i2c_port_t;
+
+typedef void *i2c_cmd_handle_t;
+
+#endif /* _DRIVER_I2C_HOST_H */
@@ -0,0 +1,22 @@
+/*
+ * spi_master.h
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#ifndef _DRIVER_SPI_MASTER_HOST_H
+#define _DRIVER_SPI_MASTER_HOST_H
+
+#include "esp_err.h"
+
+typedef enum {
+    SPI1_HOST = 0,
+    SPI2_HOST = 1,
+    SPI3_HOST = 2
+} spi_host_device_t;
+
+typedef struct spi_device_t *spi_device_handle_t;
+typedef struct spi_transaction_t spi_transaction_t;
+
+#endif /* _DRIVER_SPI_MASTER_HOST_H */
@@ -0,0 +1,17 @@
+/*
+ * esp_attr.h
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#ifndef _ESP_ATTR_HOST_H
+#define _ESP_ATTR_HOST_H
+
+#include "sdkconfig.h"
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+
+#endif /* _ESP_ATTR_HOST_H */
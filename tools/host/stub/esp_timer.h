@@ -0,0 +1,16 @@
+/*
+ * esp_timer.h
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#ifndef _ESP_TIMER_HOST_H
+#define _ESP_TIMER_HOST_H
+
+#include <stdint.h>
+
+// monotonic time in us, see esp_host.c
+extern int64_t esp_timer_get_time(void);
+
+#endif /* _ESP_TIMER_HOST_H */
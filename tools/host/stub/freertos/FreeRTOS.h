@@ -0,0 +1,42 @@
+/*
+ * FreeRTOS.h
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#ifndef _FREERTOS_HOST_H
+#define _FREERTOS_HOST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sdkconfig.h"
+
+typedef uint32_t TickType_t;
+typedef TickType_t portTickType;
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+
+typedef void *TaskHandle_t;
+typedef void *QueueHandle_t;
+typedef QueueHandle_t xQueueHandle;
+typedef void *EventGroupHandle_t;
+typedef uint32_t EventBits_t;
+
+#define pdFALSE             0
+#define pdTRUE              1
+
+#define portMAX_DELAY       0xFFFFFFFF
+#define portTICK_RATE_MS    1
+
+#define BIT7                0x00000080
+#define BIT6                0x00000040
+#define BIT5                0x00000020
+#define BIT4                0x00000010
+#define BIT3                0x00000008
+#define BIT2                0x00000004
+#define BIT1                0x00000002
+#define BIT0                0x00000001
+
+#endif /* _FREERTOS_HOST_H */
@@ -0,0 +1,17 @@
+/*
+ * event_groups.h
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#ifndef _FREERTOS_EVENT_GROUPS_HOST_H
+#define _FREERTOS_EVENT_GROUPS_HOST_H
+
+#include "freertos/FreeRTOS.h"
+
+extern EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits);
+extern EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear,
+                                       BaseType_t all, TickType_t wait);
+
+#endif /* _FREERTOS_EVENT_GROUPS_HOST_H */
@@ -0,0 +1,13 @@
+/*
+ * queue.h
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#ifndef _FREERTOS_QUEUE_HOST_H
+#define _FREERTOS_QUEUE_HOST_H
+
+#include "freertos/FreeRTOS.h"
+
+#endif /* _FREERTOS_QUEUE_HOST_H */
@@ -0,0 +1,15 @@
+/*
+ * semphr.h
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#ifndef _FREERTOS_SEMPHR_HOST_H
+#define _FREERTOS_SEMPHR_HOST_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef void *SemaphoreHandle_t;
+
+#endif /* _FREERTOS_SEMPHR_HOST_H */
@@ -0,0 +1,21 @@
+/*
+ * task.h
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#ifndef _FREERTOS_TASK_HOST_H
+#define _FREERTOS_TASK_HOST_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void *);
+
+extern BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *name, uint32_t stack, void *param,
+                                          UBaseType_t prio, TaskHandle_t *handle, BaseType_t core);
+
+extern TickType_t xTaskGetTickCount(void);
+extern void vTaskDelayUntil(TickType_t *prev, TickType_t inc);
+
+#endif /* _FREERTOS_TASK_HOST_H */
@@ -0,0 +1,241 @@
+/*
+ * test_ina219.c
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "board/ina219.h"
+
+#include "i2c_host.h"
+
+#define INA219_ADDR 0x40
+
+#define INA219_REG_CONFIG         0x00
+#define INA219_REG_SHUNT_VOLTAGE  0x01
+#define INA219_REG_BUS_VOLTAGE    0x02
+#define INA219_REG_POWER          0x03
+#define INA219_REG_CURRENT        0x04
+#define INA219_REG_CALIBRATION    0x05
+
+#define INA219_BUS_CNVR           0x0002
+
+/*
+ * Register contents for a 0.1 ohm shunt, with the values the datasheet says they stand for.
+ * The current and power registers are what the chip computes from the shunt and bus readings
+ * with the calibration of the range.
+ */
+typedef struct {
+    const char *name;
+    ina219_range_t range;
+    uint16_t cur_lsb;       // in uA
+    uint16_t bus;
+    uint16_t shunt;
+    uint16_t cur;
+    uint16_t pwr;
+    int32_t bus_mv;
+    int32_t cur_ma;
+    int32_t pwr_mw;
+} test_ina219_rec_t;
+
+static const test_ina219_rec_t test_ina219_rec[] = {
+    { "5.1V 0.52A",   INA219_RANGE_IDX_32V_2A,    100, 0x27DA, 0x1450, 0x1450, 0x052E,  5100,  520,  2652 },
+    { "12V 0.42A",    INA219_RANGE_IDX_32V_2A,    100, 0x5DC2, 0x1068, 0x1068, 0x09D8, 12000,  420,  5040 },
+    { "16.4V 1.2A",   INA219_RANGE_IDX_32V_2A,    100, 0x8022, 0x2EE0, 0x2EE0, 0x2670, 16400, 1200, 19680 },
+    { "24V 1.5A",     INA219_RANGE_IDX_32V_2A,    100, 0xBB82, 0x3A98, 0x3A98, 0x4650, 24000, 1500, 36000 },
+    { "20V -0.3A",    INA219_RANGE_IDX_32V_2A,    100, 0x9C42, 0xF448, 0xF448, 0x0BB8, 20000, -300,  6000 },
+    { "32V 0.1A",     INA219_RANGE_IDX_32V_2A,    100, 0xFA02, 0x03E8, 0x03E8, 0x0640, 32000,  100,  3200 },
+    { "12V 0.9A",     INA219_RANGE_IDX_32V_1A,     40, 0x5DC2, 0x2328, 0x57E4, 0x34BC, 12000,  900, 10800 },
+    { "5V 0.2A",      INA219_RANGE_IDX_16V_400MA,  50, 0x2712, 0x07D0, 0x0FA0, 0x03E8,  5000,  200,  1000 },
+};
+
+static int test_fail = 0;
+
+#define TEST_CHECK(name, got, exp) \
+    do { \
+        long got_ = (got), exp_ = (exp); \
+        if (got_ != exp_) { \
+            fprintf(stderr, "%s: %s is %ld, expected %ld\n", name, #got, got_, exp_); \
+            test_fail++; \
+        } \
+    } while (0)
+
+// the datasheet's conversions, section 8.6.3
+static int32_t test_bus_uv(uint16_t reg)
+{
+    return (reg >> 3) * 4000;
+}
+
+static int32_t test_shunt_uv(uint16_t reg)
+{
+    return (int16_t)reg * 10;
+}
+
+static int32_t test_cur_ua(uint16_t reg, uint16_t lsb)
+{
+    return (int16_t)reg * lsb;
+}
+
+static int32_t test_pwr_uw(uint16_t reg, uint16_t lsb)
+{
+    return reg * 20 * lsb;
+}
+
+static void test_ina219_set(const test_ina219_rec_t *rec)
+{
+    i2c_host_set_reg(INA219_ADDR, INA219_REG_BUS_VOLTAGE, rec->bus);
+    i2c_host_set_reg(INA219_ADDR, INA219_REG_SHUNT_VOLTAGE, rec->shunt);
+    i2c_host_set_reg(INA219_ADDR, INA219_REG_CURRENT, rec->cur);
+    i2c_host_set_reg(INA219_ADDR, INA219_REG_POWER, rec->pwr);
+}
+
+static void test_ina219_set_range(ina219_t *dev, ina219_range_t range)
+{
+    switch (range) {
+    case INA219_RANGE_IDX_16V_400MA:
+        ina219_set_calibration_16v_400ma(dev);
+        break;
+    case INA219_RANGE_IDX_32V_1A:
+        ina219_set_calibration_32v_1a(dev);
+        break;
+    case INA219_RANGE_IDX_32V_2A:
+    default:
+        ina219_set_calibration_32v_2a(dev);
+        break;
+    }
+
+    // the conversion running across a range switch is thrown away
+    ina219_update(dev);
+}
+
+static void test_ina219_conversion(ina219_t *dev)
+{
+    for (int i = 0; i < sizeof(test_ina219_rec) / sizeof(test_ina219_rec[0]); i++) {
+        const test_ina219_rec_t *rec = &test_ina219_rec[i];
+
+        test_ina219_set(rec);
+        test_ina219_set_range(dev, rec->range);
+
+        TEST_CHECK(rec->name, ina219_update(dev), ESP_OK);
+
+        // the records have to agree with the datasheet first
+        TEST_CHECK(rec->name, test_bus_uv(rec->bus), rec->bus_mv * 1000);
+        TEST_CHECK(rec->name, test_cur_ua(rec->cur, rec->cur_lsb), rec->cur_ma * 1000);
+        TEST_CHECK(rec->name, test_pwr_uw(rec->pwr, rec->cur_lsb), rec->pwr_mw * 1000);
+
+        TEST_CHECK(rec->name, ina219_get_bus_voltage_uv(dev), test_bus_uv(rec->bus));
+        TEST_CHECK(rec->name, ina219_get_current_ua(dev), test_cur_ua(rec->cur, rec->cur_lsb));
+        TEST_CHECK(rec->name, ina219_get_power_uw(dev), test_pwr_uw(rec->pwr, rec->cur_lsb));
+        TEST_CHECK(rec->name, ina219_get_shunt_voltage_uv(dev), test_shunt_uv(rec->shunt));
+
+        TEST_CHECK(rec->name, (int32_t)ina219_get_bus_voltage_mv(dev), rec->bus_mv);
+        TEST_CHECK(rec->name, (int32_t)ina219_get_current_ma(dev), rec->cur_ma);
+        TEST_CHECK(rec->name, (int32_t)ina219_get_power_mw(dev), rec->pwr_mw);
+    }
+}
+
+// a reading without CNVR is not taken
+static void test_ina219_not_ready(ina219_t *dev)
+{
+    const test_ina219_rec_t *rec = &test_ina219_rec[1];
+
+    test_ina219_set(rec);
+    test_ina219_set_range(dev, rec->range);
+    TEST_CHECK("not ready", ina219_update(dev), ESP_OK);
+
+    i2c_host_set_reg(INA219_ADDR, INA219_REG_BUS_VOLTAGE, 0x3E80);
+    TEST_CHECK("not ready", ina219_update(dev), ESP_ERR_NOT_FINISHED);
+    TEST_CHECK("not ready", ina219_get_bus_voltage_uv(dev), rec->bus_mv * 1000);
+}
+
+// a light load settles in the lowest range whose voltage limit still fits
+static void test_ina219_auto_range(ina219_t *dev)
+{
+    static const struct {
+        const char *name;
+        uint16_t bus;
+        ina219_range_t range;
+    } trace[] = {
+        { "auto range 5V",  0x2712, INA219_RANGE_IDX_16V_400MA },
+        { "auto range 12V", 0x5DC2, INA219_RANGE_IDX_16V_400MA },
+        { "auto range 20V", 0x9C42, INA219_RANGE_IDX_32V_1A },
+        { "auto range 24V", 0xBB82, INA219_RANGE_IDX_32V_1A },
+    };
+
+    for (int i = 0; i < sizeof(trace) / sizeof(trace[0]); i++) {
+        // 100 mA at most, in any range
+        i2c_host_set_reg(INA219_ADDR, INA219_REG_BUS_VOLTAGE, trace[i].bus);
+        i2c_host_set_reg(INA219_ADDR, INA219_REG_SHUNT_VOLTAGE, 0x03E8);
+        i2c_host_set_reg(INA219_ADDR, INA219_REG_CURRENT, 0x03E8);
+        i2c_host_set_reg(INA219_ADDR, INA219_REG_POWER, 0x0100);
+
+        ina219_set_auto_range(dev);
+
+        for (int j = 0; j < 32; j++) {
+            ina219_update(dev);
+        }
+
+        TEST_CHECK(trace[i].name, ina219_get_range(dev), trace[i].range);
+        TEST_CHECK(trace[i].name, ina219_get_bus_voltage_uv(dev), test_bus_uv(trace[i].bus));
+    }
+}
+
+// the config write that starts the next conversion is chained onto a finished reading only
+static void test_ina219_triggered(ina219_t *dev)
+{
+    const test_ina219_rec_t *rec = &test_ina219_rec[1];
+
+    test_ina219_set(rec);
+    test_ina219_set_range(dev, rec->range);
+
+    // a timing change writes the config register only
+    i2c_host_set_reg(INA219_ADDR, INA219_REG_CALIBRATION, 0x1234);
+    ina219_set_adc(dev, INA219_ADC_IDX_12BIT, INA219_MODE_IDX_TRIGGERED);
+    TEST_CHECK("adc change", i2c_host_get_reg(INA219_ADDR, INA219_REG_CALIBRATION), 0x1234);
+    TEST_CHECK("adc change", ina219_update(dev), ESP_ERR_INVALID_STATE);
+
+    i2c_host_set_reg(INA219_ADDR, INA219_REG_CONFIG, 0x0000);
+    TEST_CHECK("triggered", ina219_update(dev), ESP_OK);
+    TEST_CHECK("triggered", i2c_host_get_reg(INA219_ADDR, INA219_REG_CONFIG) & 0x0007, 0x0003);
+
+    i2c_host_set_reg(INA219_ADDR, INA219_REG_CONFIG, 0x0000);
+    i2c_host_set_reg(INA219_ADDR, INA219_REG_BUS_VOLTAGE, rec->bus & ~INA219_BUS_CNVR);
+    TEST_CHECK("triggered", ina219_update(dev), ESP_ERR_NOT_FINISHED);
+    TEST_CHECK("triggered", i2c_host_get_reg(INA219_ADDR, INA219_REG_CONFIG), 0x0000);
+
+    ina219_set_adc(dev, INA219_ADC_IDX_12BIT, INA219_MODE_IDX_CONTINUOUS);
+    test_ina219_set(rec);
+    ina219_update(dev);
+
+    i2c_host_set_reg(INA219_ADDR, INA219_REG_CONFIG, 0x0000);
+    TEST_CHECK("continuous", ina219_update(dev), ESP_OK);
+    TEST_CHECK("continuous", i2c_host_get_reg(INA219_ADDR, INA219_REG_CONFIG), 0x0000);
+}
+
+int main(int argc, char *argv[])
+{
+    ina219_init();
+
+    ina219_t *dev = ina219_get(0);
+    if (!dev) {
+        fprintf(stderr, "no sensor\n");
+        return 1;
+    }
+
+    test_ina219_conversion(dev);
+    test_ina219_not_ready(dev);
+    test_ina219_auto_range(dev);
+    test_ina219_triggered(dev);
+
+    if (test_fail) {
+        fprintf(stderr, "%d check(s) failed\n", test_fail);
+        return 1;
+    }
+
+    printf("ina219: all checks passed\n");
+
+    return 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * test_ripple.c
+ *
+ *  Created on: 2020-06-14 10:20
+ *      Author: Jack Chen <redchenjs@live.com>
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "user/ripple.h"
+
+#define TEST_RIPPLE_LEN     1024
+#define TEST_RIPPLE_SPAN    250000  // in us, as in meter_ripple()
+#define TEST_RIPPLE_CNVR    296     // in us between 10-bit conversions
+#define TEST_RIPPLE_READ    180     // in us per current read over I2C
+#define TEST_RIPPLE_LSB     0.1f    // in mA, current LSB of the 32V_2A range
+#define TEST_RIPPLE_TOL     0.02f   // relative error allowed on the frequency
+
+/*
+ * Fan supply currents as meter_ripple() records them: reads come faster than conversions, so
+ * most values repeat, and each one is quantised to the current LSB. The ripple is a sawtooth
+ * that drops at every commutation, with a second harmonic and read noise on top.
+ */
+typedef struct {
+    const char *name;
+    float dc;           // in mA
+    float ripple;       // in mA, peak to peak
+    float freq;         // in Hz at the start of the trace
+    float drift;        // in Hz at the end of the trace, 0 for a steady fan
+    float noise;        // in mA, peak
+    uint32_t freq_mhz;  // expected estimate, 0 for none
+} test_ripple_rec_t;
+
+static const test_ripple_rec_t test_ripple_rec[] = {
+    { "600 rpm",            95.0f,  6.0f,  40.0f,   0.0f, 0.4f,  40000 },
+    { "1200 rpm",          140.0f,  8.0f,  80.0f,   0.0f, 0.6f,  80000 },
+    { "2400 rpm",          210.0f, 10.0f, 160.0f,   0.0f, 0.8f, 160000 },
+    { "3600 rpm",          320.0f, 12.0f, 240.0f,   0.0f, 1.0f, 240000 },
+    { "weak ripple",       150.0f,  1.0f,  80.0f,   0.0f, 0.4f,      0 },
+    { "dc and noise",      150.0f,  0.0f,   0.0f,   0.0f, 2.0f,      0 },
+    { "spinning up",       120.0f,  8.0f,  40.0f, 160.0f, 0.6f,      0 },
+};
+
+static int test_fail = 0;
+
+static uint32_t test_rand_state = 1;
+
+// a fixed LCG, so the traces are the same on every run
+static float test_rand(void)
+{
+    test_rand_state = test_rand_state * 1103515245 + 12345;
+
+    return ((test_rand_state >> 16) & 0x7FFF) / 16383.5f - 1.0f;
+}
+
+static float test_ripple_current(const test_ripple_rec_t *rec, uint32_t t)
+{
+    float s = t / 1000000.0f;
+    float f1 = rec->drift ? rec->drift : rec->freq;
+    // the phase of a frequency going linearly from freq to f1 over the span
+    float cycles = rec->freq * s + (f1 - rec->freq) * s * s / (2.0f * TEST_RIPPLE_SPAN / 1000000.0f);
+    float x = cycles - floorf(cycles);
+    float saw = (x < 0.9f) ? x / 0.9f : (1.0f - x) / 0.1f;
+
+    return rec->dc + rec->ripple * (saw - 0.5f) + 0.15f * rec->ripple * sinf(4.0f * M_PI * cycles);
+}
+
+static uint16_t test_ripple_trace(const test_ripple_rec_t *rec, meter_sample_t *samples)
+{
+    uint16_t count = 0;
+    uint32_t t = 0, cnvr = (uint32_t)-1;
+    float current = 0.0f;
+
+    test_rand_state = 1;
+
+    while (count < TEST_RIPPLE_LEN) {
+        // a new value only once the next conversion is done
+        if (t / TEST_RIPPLE_CNVR != cnvr) {
+            cnvr = t / TEST_RIPPLE_CNVR;
+
+            current = test_ripple_current(rec, cnvr * TEST_RIPPLE_CNVR) + rec->noise * test_rand();
+            current = roundf(current / TEST_RIPPLE_LSB) * TEST_RIPPLE_LSB;
+        }
+
+        samples[count].time = t;
+        samples[count].current = current;
+
+        if (samples[count++].time >= TEST_RIPPLE_SPAN) {
+            break;
+        }
+
+        t += TEST_RIPPLE_READ + (uint32_t)(20.0f * test_rand());
+    }
+
+    return count;
+}
+
+static void test_ripple_check(const char *name, const meter_sample_t *samples, uint16_t count, uint32_t exp)
+{
+    uint32_t got = ripple_estimate(samples, count);
+
+    if (exp ? fabsf((float)got - exp) > TEST_RIPPLE_TOL * exp : got != 0) {
+        fprintf(stderr, "%s: ripple is %u mHz, expected %u mHz\n", name, got, exp);
+        test_fail++;
+    } else {
+        printf("%-16s %7u mHz\n", name, got);
+    }
+}
+
+// a PM+DMP dump, one "time_us,current_ma" line per sample
+static uint16_t test_ripple_load(const char *path, meter_sample_t *samples)
+{
+    uint16_t count = 0;
+
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        perror(path);
+        exit(1);
+    }
+
+    while (count < METER_CAPTURE_MAX
+           && fscanf(fp, "%u,%f", &samples[count].time, &samples[count].current) == 2) {
+        count++;
+    }
+
+    fclose(fp);
+
+    return count;
+}
+
+/*
+ * test_ripple [dump.csv expected_mhz]...
+ */
+int main(int argc, char *argv[])
+{
+    static meter_sample_t samples[METER_CAPTURE_MAX];
+    uint16_t count;
+
+    for (int i = 0; i < sizeof(test_ripple_rec) / sizeof(test_ripple_rec[0]); i++) {
+        count = test_ripple_trace(&test_ripple_rec[i], samples);
+
+        test_ripple_check(test_ripple_rec[i].name, samples, count, test_ripple_rec[i].freq_mhz);
+    }
+
+    // too short for the crossings needed
+    count = test_ripple_trace(&test_ripple_rec[1], samples);
+    test_ripple_check("short", samples, 40, 0);
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        count = test_ripple_load(argv[i], samples);
+
+        test_ripple_check(argv[i], samples, count, strtoul(argv[i + 1], NULL, 0));
+    }
+
+    if (test_fail) {
+        fprintf(stderr, "%d check(s) failed\n", test_fail);
+        return 1;
+    }
+
+    printf("ripple: all checks passed\n");
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+#
+# pack_assets.py
+#
+#  Packs UI asset files into an image for the "assets" flash partition,
+#  read on the device by the uGFX memory-mapped file system (GFILE_NEED_MMAPFS).
+#
+#  Usage:
+#    tools/pack_assets.py -o build/assets.bin assets/*.bmp
+#    esptool.py write_flash 0x3c0000 build/assets.bin
+#
+
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = b'GUFA'
+VERSION = 1
+NAME_LEN = 24
+ALIGN = 4
+
+HEADER = struct.Struct('<4sHHI')
+DIRENTRY = struct.Struct('<%dsII' % NAME_LEN)
+
+
+def align(n):
+    return (n + ALIGN - 1) & ~(ALIGN - 1)
+
+
+def pack(files, size):
+    entries = []
+    for path in files:
+        name = os.path.basename(path).encode('ascii')
+        if len(name) >= NAME_LEN:
+            sys.exit('%s: name longer than %d characters' % (path, NAME_LEN - 1))
+        if name in (e[0] for e in entries):
+            sys.exit('%s: duplicate name' % path)
+        with open(path, 'rb') as f:
+            entries.append((name, f.read()))
+
+    offset = align(HEADER.size + DIRENTRY.size * len(entries))
+    table = b''
+    data = b''
+    for name, blob in entries:
+        table += DIRENTRY.pack(name, offset + len(data), len(blob))
+        data += blob + b'\0' * (align(len(blob)) - len(blob))
+
+    head = HEADER.pack(MAGIC, VERSION, len(entries), offset + len(data))
+    image = head + table
+    image += b'\0' * (offset - len(image)) + data
+
+    if size and len(image) > size:
+        sys.exit('image is %d bytes, partition is only %d bytes' % (len(image), size))
+
+    return image
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Pack asset files into a GFILE mmap image.')
+    parser.add_argument('-o', '--output', required=True, help='output image file')
+    parser.add_argument('-s', '--size', type=lambda x: int(x, 0), default=0x40000,
+                        help='partition size, 0 to skip the check (default: 0x40000)')
+    parser.add_argument('files', nargs='*', help='asset files, stored by base name')
+    args = parser.parse_args()
+
+    image = pack(args.files, args.size)
+
+    with open(args.output, 'wb') as f:
+        f.write(image)
+
+    print('%s: %d files, %d bytes' % (args.output, len(args.files), len(image)))
+
+
+if __name__ == '__main__':
+    main()